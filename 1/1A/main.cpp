@@ -1,12 +1,33 @@
 // 82825957
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -317,6 +338,161 @@ class ListGraph : public Graph<Vertex, Edge, std::list<Edge>> {
   std::unordered_map<Vertex, std::list<Edge>> adjacent_;
 };
 
+// Отсортированные списки соседей хранятся разностями в varint-кодировке
+// и декодируются прямо во время обхода. Вершины -- числа из [0, n).
+template <typename Vertex = size_t, typename Edge = std::pair<Vertex, Vertex>>
+class CompressedGraph {
+ public:
+  class NeighbourIterator {
+   public:
+    NeighbourIterator(const uint8_t* pos, const uint8_t* end)
+        : pos_(pos), next_(pos), end_(end) {
+      Decode();
+    }
+
+    NeighbourIterator& operator++() {
+      pos_ = next_;
+      Decode();
+      return *this;
+    }
+
+    bool operator==(const NeighbourIterator& other) const {
+      return pos_ == other.pos_;
+    }
+
+    bool operator!=(const NeighbourIterator& other) const {
+      return pos_ != other.pos_;
+    }
+
+    Vertex operator*() const { return value_; }
+
+   private:
+    void Decode() {
+      if (pos_ == end_) {
+        return;
+      }
+      Vertex gap = 0;
+      size_t shift = 0;
+      while ((*next_ & kContinuation) != 0) {
+        gap |= static_cast<Vertex>(*next_++ & kPayload) << shift;
+        shift += kPayloadBits;
+      }
+      gap |= static_cast<Vertex>(*next_++) << shift;
+      value_ += gap;
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* next_;
+    const uint8_t* end_;
+    Vertex value_ = 0;
+  };
+
+  class NeighbourRange {
+   public:
+    NeighbourRange(const uint8_t* begin, const uint8_t* end)
+        : begin_(begin), end_(end) {}
+
+    // NOLINTNEXTLINE
+    NeighbourIterator begin() const { return {begin_, end_}; }
+
+    // NOLINTNEXTLINE
+    NeighbourIterator end() const { return {end_, end_}; }
+
+   private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+  };
+
+  template <typename EContainer>
+  CompressedGraph(size_t num_vertices, const EContainer& edges)
+      : offsets_(num_vertices + 1, 0) {
+    std::vector<size_t> starts(num_vertices + 1, 0);
+    for (const Edge& edge : edges) {
+      ++starts[edge.first];
+      ++starts[edge.second];
+    }
+    size_t total = 0;
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      std::swap(starts[vertex], total);
+      total += starts[vertex];
+    }
+    starts[num_vertices] = total;
+    std::vector<Vertex> neighbours(total);
+    std::vector<size_t> fill(starts.begin(), starts.end() - 1);
+    for (const Edge& edge : edges) {
+      neighbours[fill[edge.first]++] = edge.second;
+      neighbours[fill[edge.second]++] = edge.first;
+    }
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      auto first = neighbours.begin() + starts[vertex];
+      auto last = neighbours.begin() + starts[vertex + 1];
+      std::sort(first, last);
+      Vertex prev = 0;
+      for (auto iter = first; iter != last; ++iter) {
+        Encode(*iter - prev);
+        prev = *iter;
+      }
+      offsets_[vertex + 1] = data_.size();
+    }
+    data_.shrink_to_fit();
+    num_edges_ = total / 2;
+  }
+
+  size_t VerticesCount() const { return offsets_.size() - 1; }
+
+  size_t EdgesCount() const { return num_edges_; }
+
+  NeighbourRange GetNeighbours(const Vertex& vertex) const {
+    return {data_.data() + offsets_[vertex],
+            data_.data() + offsets_[vertex + 1]};
+  }
+
+  std::vector<Vertex> GetVertices() const {
+    std::vector<Vertex> res(VerticesCount());
+    std::iota(res.begin(), res.end(), 0);
+    return res;
+  }
+
+  bool HasEdge(const Vertex& first, const Vertex& second) const {
+    if (first >= VerticesCount()) {
+      return false;
+    }
+    for (Vertex next : GetNeighbours(first)) {
+      if (next >= second) {
+        return next == second;
+      }
+    }
+    return false;
+  }
+
+  std::optional<Edge> GetEdge(const Vertex& first, const Vertex& second) const {
+    if (!HasEdge(first, second)) {
+      return std::nullopt;
+    }
+    return Edge{first, second};
+  }
+
+  using VertexType = Vertex;
+  using EdgeType = Edge;
+
+ private:
+  void Encode(Vertex gap) {
+    while (gap > kPayload) {
+      data_.push_back(static_cast<uint8_t>(gap & kPayload) | kContinuation);
+      gap >>= kPayloadBits;
+    }
+    data_.push_back(static_cast<uint8_t>(gap));
+  }
+
+  static constexpr size_t kPayloadBits = 7;
+  static constexpr uint8_t kPayload = 0x7F;
+  static constexpr uint8_t kContinuation = 0x80;
+
+  std::vector<size_t> offsets_;
+  std::vector<uint8_t> data_;
+  size_t num_edges_ = 0;
+};
+
 template <typename Vertex, typename Edge>
 class Visitor {
  public:
@@ -385,6 +561,82 @@ class ParentVisitor : public Visitor<Vertex, Edge> {
   std::unordered_map<Vertex, Vertex> parents_;
 };
 
+// Ленивый генератор на корутинах: значения вычисляются по мере обхода,
+// а прерванный цикл сразу освобождает состояние корутины.
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    const T* value = nullptr;
+
+    Generator get_return_object() {
+      return Generator{Handle::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(const T& item) {
+      value = std::addressof(item);
+      return {};
+    }
+
+    void return_void() {}
+
+    void unhandled_exception() { throw; }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  struct Sentinel {};
+
+  class Iterator {
+   public:
+    explicit Iterator(Handle handle) : handle_(handle) {}
+
+    Iterator& operator++() {
+      handle_.resume();
+      return *this;
+    }
+
+    const T& operator*() const { return *handle_.promise().value; }
+
+    bool operator==(Sentinel /*unused*/) const { return handle_.done(); }
+
+    bool operator!=(Sentinel /*unused*/) const { return !handle_.done(); }
+
+   private:
+    Handle handle_;
+  };
+
+  explicit Generator(Handle handle) : handle_(handle) {}
+
+  Generator(Generator&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+
+  ~Generator() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  // NOLINTNEXTLINE
+  Iterator begin() {
+    handle_.resume();
+    return Iterator(handle_);
+  }
+
+  // NOLINTNEXTLINE
+  Sentinel end() const { return {}; }
+
+ private:
+  Handle handle_;
+};
+
 template <typename Graph, typename Visitor>
 class BFS {
   enum class VertexColor { WHITE, GRAY, BLACK };
@@ -411,7 +663,7 @@ class BFS {
       visitor_.ExamineVertex(cur);
       vertices.pop();
       for (auto next : graph_.GetNeighbours(cur)) {
-        auto edge = *(graph_.GetEdge(cur, next));
+        typename Graph::EdgeType edge{cur, next};
         visitor_.ExamineEdge(edge);
         if (colors[next] == VertexColor::WHITE) {
           visitor_.TreeEdge(edge);
@@ -431,40 +683,1196 @@ class BFS {
     }
   }
 
+  // Вершины в порядке обхода; BFS должен пережить генератор.
+  Generator<typename Graph::VertexType> Vertices(
+      typename Graph::VertexType start) const {
+    std::unordered_set<typename Graph::VertexType> discovered{start};
+    std::queue<typename Graph::VertexType> vertices;
+    vertices.push(start);
+    while (!vertices.empty()) {
+      auto cur = vertices.front();
+      vertices.pop();
+      co_yield cur;
+      for (auto next : graph_.GetNeighbours(cur)) {
+        if (discovered.insert(next).second) {
+          vertices.push(next);
+        }
+      }
+    }
+  }
+
+  // Рёбра дерева обхода в порядке их обнаружения.
+  Generator<typename Graph::EdgeType> TreeEdges(
+      typename Graph::VertexType start) const {
+    std::unordered_set<typename Graph::VertexType> discovered{start};
+    std::queue<typename Graph::VertexType> vertices;
+    vertices.push(start);
+    while (!vertices.empty()) {
+      auto cur = vertices.front();
+      vertices.pop();
+      for (auto next : graph_.GetNeighbours(cur)) {
+        if (discovered.insert(next).second) {
+          vertices.push(next);
+          co_yield typename Graph::EdgeType{cur, next};
+        }
+      }
+    }
+  }
+
   const Visitor& GetVisitor() const { return visitor_; }
 
  private:
-  Graph graph_;
+  const Graph& graph_;
   Visitor visitor_;
 };
 
-int main() {
-  size_t num_vertices;
-  size_t num_edges;
-  std::cin >> num_vertices >> num_edges;
-  size_t start;
-  size_t finish;
-  std::cin >> start >> finish;
-  std::vector<std::pair<size_t, size_t>> edges(num_edges);
+struct EdgeRecord {
+  uint32_t first;
+  uint32_t second;
+
+  bool operator<(const EdgeRecord& other) const {
+    return std::tie(first, second) < std::tie(other.first, other.second);
+  }
+};
+
+uint32_t CheckedEdgeVertex(size_t vertex) {
+  if (vertex > std::numeric_limits<uint32_t>::max()) {
+    throw std::overflow_error("vertex id does not fit into the edge file");
+  }
+  return static_cast<uint32_t>(vertex);
+}
+
+using EdgeRunFile = std::unique_ptr<FILE, decltype(&fclose)>;
+
+// Буферизованное чтение отсортированной серии из временного файла.
+class EdgeRunReader {
+ public:
+  EdgeRunReader(FILE* file) : file_(file), buffer_(kBufferRecords) {
+    rewind(file_);
+    Fill();
+  }
+
+  bool Empty() const { return pos_ == size_; }
+  const EdgeRecord& Front() const { return buffer_[pos_]; }
+  bool Failed() const { return ferror(file_) != 0; }
+
+  void Pop() {
+    if (++pos_ == size_) {
+      Fill();
+    }
+  }
+
+ private:
+  static constexpr size_t kBufferRecords = 1 << 16;
+
+  void Fill() {
+    size_ = fread(buffer_.data(), sizeof(EdgeRecord), buffer_.size(), file_);
+    pos_ = 0;
+  }
+
+  FILE* file_;
+  std::vector<EdgeRecord> buffer_;
+  size_t pos_ = 0;
+  size_t size_ = 0;
+};
+
+// Файл рёбер: записи EdgeRecord обоих направлений, отсортированные по first.
+// Сортировка внешняя: в памяти собирается одна серия из run_records
+// записей, отсортированные серии пишутся во временные файлы и затем
+// сливаются через кучу. Рёбра по одному выдаёт read_edge(), так что весь
+// граф в памяти не нужен.
+template <typename ReadEdge>
+bool WriteEdgeFile(const char* path, size_t num_edges, ReadEdge read_edge,
+                   size_t run_records = 1 << 22) {
+  std::vector<EdgeRunFile> runs;
+  std::vector<EdgeRecord> records;
+  records.reserve(std::min(run_records, 2 * num_edges));
+  auto flush = [&]() {
+    std::sort(records.begin(), records.end());
+    runs.emplace_back(std::tmpfile(), &fclose);
+    if (runs.back() == nullptr) {
+      return false;
+    }
+    size_t written = fwrite(records.data(), sizeof(EdgeRecord),
+                            records.size(), runs.back().get());
+    bool complete = (written == records.size());
+    records.clear();
+    return complete;
+  };
   for (size_t i = 0; i < num_edges; ++i) {
-    std::cin >> edges[i].first >> edges[i].second;
+    auto edge = read_edge();
+    uint32_t first = CheckedEdgeVertex(edge.first);
+    uint32_t second = CheckedEdgeVertex(edge.second);
+    for (auto record : {EdgeRecord{first, second}, EdgeRecord{second, first}}) {
+      records.push_back(record);
+      if ((records.size() == run_records) && !flush()) {
+        return false;
+      }
+    }
+  }
+  if (!records.empty() && !flush()) {
+    return false;
+  }
+  EdgeRunFile file(fopen(path, "wb"), &fclose);
+  if (file == nullptr) {
+    return false;
+  }
+  std::vector<EdgeRunReader> readers;
+  readers.reserve(runs.size());
+  auto greater = [&](size_t lhs, size_t rhs) {
+    return readers[rhs].Front() < readers[lhs].Front();
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(
+      greater);
+  for (auto& run : runs) {
+    readers.emplace_back(run.get());
+    if (!readers.back().Empty()) {
+      heap.push(readers.size() - 1);
+    }
+  }
+  while (!heap.empty()) {
+    size_t run = heap.top();
+    heap.pop();
+    records.push_back(readers[run].Front());
+    readers[run].Pop();
+    if (!readers[run].Empty()) {
+      heap.push(run);
+    }
+    if ((records.size() == run_records) || heap.empty()) {
+      size_t written = fwrite(records.data(), sizeof(EdgeRecord),
+                              records.size(), file.get());
+      if (written != records.size()) {
+        return false;
+      }
+      records.clear();
+    }
+  }
+  for (const auto& reader : readers) {
+    if (reader.Failed()) {
+      return false;
+    }
+  }
+  return fclose(file.release()) == 0;
+}
+
+class EdgeFileScanner {
+ public:
+  EdgeFileScanner(const char* path)
+      : fd_(open(path, O_RDONLY)),
+        buffer_(static_cast<char*>(std::aligned_alloc(kAlignment, kBlockSize)),
+                &std::free) {
+    if (fd_ < 0) {
+      throw std::runtime_error(std::string("cannot open ") + path);
+    }
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  EdgeFileScanner(const EdgeFileScanner&) = delete;
+  EdgeFileScanner& operator=(const EdgeFileScanner&) = delete;
+
+  ~EdgeFileScanner() { close(fd_); }
+
+  template <typename Callback>
+  void Scan(Callback callback) const {
+    off_t offset = 0;
+    while (true) {
+      ssize_t len = pread(fd_, buffer_.get(), kBlockSize, offset);
+      if (len < 0) {
+        throw std::runtime_error("edge file read failed");
+      }
+      size_t count = static_cast<size_t>(len) / sizeof(EdgeRecord);
+      if (count == 0) {
+        return;
+      }
+      const auto* records = reinterpret_cast<const EdgeRecord*>(buffer_.get());
+      for (size_t i = 0; i < count; ++i) {
+        callback(records[i]);
+      }
+      offset += count * sizeof(EdgeRecord);
+    }
+  }
+
+ private:
+  static constexpr size_t kAlignment = 4096;
+  static constexpr size_t kBlockSize = 1 << 23;
+
+  int fd_;
+  std::unique_ptr<char, decltype(&std::free)> buffer_;
+};
+
+// Расстояния и предки лежат в памяти, а рёбра читаются с диска: каждый
+// уровень обхода -- один последовательный проход по файлу.
+class SemiExternalBFS {
+ public:
+  SemiExternalBFS(const char* path, size_t num_vertices)
+      : scanner_(path),
+        dist_(num_vertices, kInfinity),
+        parents_(num_vertices, kInfinity) {}
+
+  void operator()(size_t start, std::optional<size_t> finish = std::nullopt) {
+    std::fill(dist_.begin(), dist_.end(), kInfinity);
+    std::fill(parents_.begin(), parents_.end(), kInfinity);
+    num_scans_ = 0;
+    if (start >= dist_.size()) {
+      return;
+    }
+    size_t target = finish.value_or(dist_.size());
+    dist_[start] = 0;
+    uint32_t level = 0;
+    bool discovered = true;
+    while (discovered &&
+           ((target >= dist_.size()) || (dist_[target] == kInfinity))) {
+      discovered = false;
+      scanner_.Scan([&](const EdgeRecord& edge) {
+        if ((edge.first >= dist_.size()) || (edge.second >= dist_.size())) {
+          throw std::out_of_range("edge file vertex exceeds the vertex count");
+        }
+        if ((dist_[edge.first] == level) && (dist_[edge.second] == kInfinity)) {
+          dist_[edge.second] = level + 1;
+          parents_[edge.second] = edge.first;
+          discovered = true;
+        }
+      });
+      ++num_scans_;
+      ++level;
+    }
+  }
+
+  std::vector<size_t> GetPath(size_t first, size_t second) const {
+    if ((second >= dist_.size()) || (dist_[second] == kInfinity)) {
+      return std::vector<size_t>();
+    }
+    std::vector<size_t> res;
+    res.push_back(second);
+    while (res.back() != first) {
+      res.push_back(parents_[res.back()]);
+    }
+    std::reverse(res.begin(), res.end());
+    return res;
+  }
+
+  size_t ScansCount() const { return num_scans_; }
+
+ private:
+  static constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+  EdgeFileScanner scanner_;
+  std::vector<uint32_t> dist_;
+  std::vector<uint32_t> parents_;
+  size_t num_scans_ = 0;
+};
+
+template <typename Graph, typename Visitor>
+std::vector<typename Graph::VertexType> FindPath(
+    const BFS<Graph, Visitor>& finder, typename Graph::VertexType start,
+    typename Graph::VertexType finish) {
+  if (start == finish) {
+    return {start};
+  }
+  std::unordered_map<typename Graph::VertexType, typename Graph::VertexType>
+      parents;
+  for (const auto& edge : finder.TreeEdges(start)) {
+    parents[edge.second] = edge.first;
+    if (edge.second == finish) {
+      break;
+    }
+  }
+  if (parents.count(finish) == 0) {
+    return {};
+  }
+  std::vector<typename Graph::VertexType> res{finish};
+  while (res.back() != start) {
+    res.push_back(parents.at(res.back()));
+  }
+  std::reverse(res.begin(), res.end());
+  return res;
+}
+
+template <typename Vertex = size_t, typename Edge = std::pair<size_t, size_t>>
+class DistanceVisitor : public Visitor<Vertex, Edge> {
+ public:
+  static constexpr size_t kInfinity = std::numeric_limits<size_t>::max();
+
+  explicit DistanceVisitor(size_t num_vertices)
+      : dist_(num_vertices, kInfinity) {}
+
+  void Initialize(const Vertex& vertex) override { dist_[vertex] = kInfinity; }
+
+  void Discover(const Vertex& vertex) override {
+    dist_[vertex] = 0;
+    farthest_ = vertex;
   }
-  std::vector<size_t> vertices(num_vertices);
-  for (size_t i = 0; i < num_vertices; ++i) {
-    vertices[i] = i;
+
+  // BFS выдаёт рёбра дерева по уровням, так что последняя найденная вершина
+  // -- одна из самых далёких.
+  void TreeEdge(const Edge& edge) override {
+    dist_[edge.second] = dist_[edge.first] + 1;
+    farthest_ = edge.second;
   }
-  ListGraph<> graph(vertices, edges);
-  BFS<ListGraph<>, ParentVisitor<>> finder(graph);
-  finder(start);
-  std::vector<size_t> path = finder.GetVisitor().GetPath(start, finish);
+
+  size_t GetDistance(const Vertex& vertex) const { return dist_[vertex]; }
+
+  Vertex GetFarthest() const { return farthest_; }
+
+  size_t GetEccentricity() const { return dist_[farthest_]; }
+
+ private:
+  std::vector<size_t> dist_;
+  Vertex farthest_ = Vertex();
+};
+
+// Диаметр, радиус и эксцентриситеты компоненты связности. Диаметр ищется
+// двойным проходом и iFUB, эксцентриситеты -- сужением верхних и нижних
+// оценок (Takes--Kosters), так что обычно хватает нескольких запусков BFS.
+// Вершины -- числа из [0, n).
+template <typename Graph>
+class EccentricityFinder {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using EdgeType = typename Graph::EdgeType;
+
+  static constexpr size_t kInfinity =
+      DistanceVisitor<VertexType, EdgeType>::kInfinity;
+
+  explicit EccentricityFinder(const Graph& graph)
+      : graph_(graph),
+        finder_(graph, DistanceVisitor<VertexType, EdgeType>(
+                           graph.VerticesCount())) {}
+
+  size_t Diameter(VertexType root) {
+    VertexType first = Run(root).GetFarthest();
+    const auto& visitor = Run(first);
+    size_t lower = visitor.GetEccentricity();
+    VertexType center = visitor.GetFarthest();
+    for (size_t step = 0; step < lower / 2; ++step) {
+      for (VertexType next : graph_.GetNeighbours(center)) {
+        if (visitor.GetDistance(next) + 1 == visitor.GetDistance(center)) {
+          center = next;
+          break;
+        }
+      }
+    }
+    std::vector<std::vector<VertexType>> fringes = Levels(center);
+    lower = std::max(lower, fringes.size() - 1);
+    for (size_t level = fringes.size() - 1; 2 * level > lower; --level) {
+      for (VertexType vertex : fringes[level]) {
+        lower = std::max(lower, Run(vertex).GetEccentricity());
+        if (lower == 2 * level) {
+          return lower;
+        }
+      }
+      if (lower > 2 * (level - 1)) {
+        break;
+      }
+    }
+    return lower;
+  }
+
+  std::vector<size_t> Eccentricities(VertexType root) {
+    std::vector<size_t> res(graph_.VerticesCount(), kInfinity);
+    std::vector<size_t> lower(graph_.VerticesCount(), 0);
+    std::vector<size_t> upper(graph_.VerticesCount(), kInfinity);
+    std::vector<VertexType> candidates;
+    for (const auto& fringe : Levels(root)) {
+      candidates.insert(candidates.end(), fringe.begin(), fringe.end());
+    }
+    bool by_upper = true;
+    while (!candidates.empty()) {
+      auto chosen = std::min_element(
+          candidates.begin(), candidates.end(),
+          [&](VertexType first, VertexType second) {
+            return by_upper ? (upper[first] > upper[second])
+                            : (lower[first] < lower[second]);
+          });
+      by_upper = !by_upper;
+      const auto& visitor = Run(*chosen);
+      size_t eccentricity = visitor.GetEccentricity();
+      for (VertexType vertex : candidates) {
+        size_t dist = visitor.GetDistance(vertex);
+        lower[vertex] = std::max({lower[vertex], dist, eccentricity - dist});
+        upper[vertex] = std::min(upper[vertex], eccentricity + dist);
+      }
+      auto resolved = std::partition(
+          candidates.begin(), candidates.end(),
+          [&](VertexType vertex) { return lower[vertex] != upper[vertex]; });
+      for (auto iter = resolved; iter != candidates.end(); ++iter) {
+        res[*iter] = lower[*iter];
+      }
+      candidates.erase(resolved, candidates.end());
+    }
+    return res;
+  }
+
+  // Вершины, у которых нижняя оценка не меньше найденного радиуса, больше
+  // не рассматриваются.
+  size_t Radius(VertexType root) {
+    std::vector<size_t> lower(graph_.VerticesCount(), 0);
+    std::vector<VertexType> candidates;
+    for (const auto& fringe : Levels(root)) {
+      candidates.insert(candidates.end(), fringe.begin(), fringe.end());
+    }
+    size_t res = kInfinity;
+    while (!candidates.empty()) {
+      auto chosen = std::min_element(candidates.begin(), candidates.end(),
+                                     [&](VertexType first, VertexType second) {
+                                       return lower[first] < lower[second];
+                                     });
+      const auto& visitor = Run(*chosen);
+      size_t eccentricity = visitor.GetEccentricity();
+      res = std::min(res, eccentricity);
+      for (VertexType vertex : candidates) {
+        size_t dist = visitor.GetDistance(vertex);
+        lower[vertex] = std::max({lower[vertex], dist, eccentricity - dist});
+      }
+      candidates.erase(
+          std::remove_if(
+              candidates.begin(), candidates.end(),
+              [&](VertexType vertex) { return lower[vertex] >= res; }),
+          candidates.end());
+    }
+    return res;
+  }
+
+  size_t RunsCount() const { return num_runs_; }
+
+ private:
+  const DistanceVisitor<VertexType, EdgeType>& Run(VertexType start) {
+    ++num_runs_;
+    finder_(start);
+    return finder_.GetVisitor();
+  }
+
+  std::vector<std::vector<VertexType>> Levels(VertexType start) {
+    const auto& visitor = Run(start);
+    std::vector<std::vector<VertexType>> res(visitor.GetEccentricity() + 1);
+    for (VertexType vertex : graph_.GetVertices()) {
+      if (visitor.GetDistance(vertex) != kInfinity) {
+        res[visitor.GetDistance(vertex)].push_back(vertex);
+      }
+    }
+    return res;
+  }
+
+  const Graph& graph_;
+  BFS<Graph, DistanceVisitor<VertexType, EdgeType>> finder_;
+  size_t num_runs_ = 0;
+};
+
+// Кэш деревьев BFS для повторяющихся источников: на каждый источник хранится
+// плоский массив предков, при нехватке памяти вытесняется давно не
+// использованный. Вершины -- числа из [0, n).
+template <typename Graph>
+class PathQueryCache {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  PathQueryCache(const Graph& graph, size_t memory_limit)
+      : graph_(graph),
+        capacity_(std::max<size_t>(
+            1, memory_limit / std::max<size_t>(1, TreeMemory()))) {}
+
+  std::vector<VertexType> GetPath(VertexType start, VertexType finish) {
+    if ((start >= graph_.VerticesCount()) ||
+        (finish >= graph_.VerticesCount())) {
+      return {};
+    }
+    const std::vector<VertexType>& parents = GetTree(start);
+    if ((finish != start) && (parents[finish] == kNoParent)) {
+      return {};
+    }
+    std::vector<VertexType> res{finish};
+    while (res.back() != start) {
+      res.push_back(parents[res.back()]);
+    }
+    std::reverse(res.begin(), res.end());
+    return res;
+  }
+
+  size_t Hits() const { return hits_; }
+
+  size_t Misses() const { return misses_; }
+
+ private:
+  static constexpr VertexType kNoParent =
+      std::numeric_limits<VertexType>::max();
+
+  size_t TreeMemory() const {
+    return graph_.VerticesCount() * sizeof(VertexType);
+  }
+
+  const std::vector<VertexType>& GetTree(VertexType start) {
+    auto found = index_.find(start);
+    if (found != index_.end()) {
+      ++hits_;
+      trees_.splice(trees_.begin(), trees_, found->second);
+      return found->second->second;
+    }
+    ++misses_;
+    if (trees_.size() == capacity_) {
+      index_.erase(trees_.back().first);
+      trees_.pop_back();
+    }
+    trees_.emplace_front(start, BuildTree(start));
+    index_[start] = trees_.begin();
+    return trees_.front().second;
+  }
+
+  std::vector<VertexType> BuildTree(VertexType start) const {
+    std::vector<VertexType> parents(graph_.VerticesCount(), kNoParent);
+    std::queue<VertexType> vertices;
+    parents[start] = start;
+    vertices.push(start);
+    while (!vertices.empty()) {
+      auto cur = vertices.front();
+      vertices.pop();
+      for (VertexType next : graph_.GetNeighbours(cur)) {
+        if (parents[next] == kNoParent) {
+          parents[next] = cur;
+          vertices.push(next);
+        }
+      }
+    }
+    return parents;
+  }
+
+  const Graph& graph_;
+  size_t capacity_;
+  std::list<std::pair<VertexType, std::vector<VertexType>>> trees_;
+  std::unordered_map<
+      VertexType,
+      typename std::list<
+          std::pair<VertexType, std::vector<VertexType>>>::iterator>
+      index_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+// Расстояния от одного источника при вставке и удалении рёбер: пересчитываются
+// только затронутые вершины (в духе Ramalingam--Reps для единичных весов).
+// Вершины -- числа из [0, n).
+template <typename Vertex = size_t>
+class DynamicBFS {
+ public:
+  static constexpr Vertex kInfinity = std::numeric_limits<Vertex>::max();
+
+  template <typename EContainer>
+  DynamicBFS(size_t num_vertices, const EContainer& edges, Vertex source)
+      : adjacent_(num_vertices),
+        dist_(num_vertices, kInfinity),
+        parents_(num_vertices, kInfinity),
+        affected_(num_vertices, false),
+        source_(source) {
+    for (auto edge : edges) {
+      adjacent_[edge.first].push_back(edge.second);
+      adjacent_[edge.second].push_back(edge.first);
+    }
+    dist_[source_] = 0;
+    std::queue<Vertex> vertices;
+    vertices.push(source_);
+    Propagate(vertices);
+  }
+
+  void InsertEdge(Vertex first, Vertex second) {
+    adjacent_[first].push_back(second);
+    adjacent_[second].push_back(first);
+    std::queue<Vertex> vertices;
+    if (Relax(first, second)) {
+      vertices.push(second);
+    } else if (Relax(second, first)) {
+      vertices.push(first);
+    }
+    Propagate(vertices);
+  }
+
+  void DeleteEdge(Vertex first, Vertex second) {
+    if (!Erase(first, second)) {
+      return;
+    }
+    Erase(second, first);
+    if (parents_[second] == first) {
+      Repair(second);
+    } else if (parents_[first] == second) {
+      Repair(first);
+    }
+  }
+
+  Vertex GetDistance(Vertex vertex) const { return dist_[vertex]; }
+
+  std::vector<Vertex> GetPath(Vertex target) const {
+    if (dist_[target] == kInfinity) {
+      return {};
+    }
+    std::vector<Vertex> res{target};
+    while (res.back() != source_) {
+      res.push_back(parents_[res.back()]);
+    }
+    std::reverse(res.begin(), res.end());
+    return res;
+  }
+
+ private:
+  bool Relax(Vertex from, Vertex to) {
+    if ((dist_[from] == kInfinity) || (dist_[from] + 1 >= dist_[to])) {
+      return false;
+    }
+    dist_[to] = dist_[from] + 1;
+    parents_[to] = from;
+    return true;
+  }
+
+  void Propagate(std::queue<Vertex>& vertices) {
+    while (!vertices.empty()) {
+      Vertex cur = vertices.front();
+      vertices.pop();
+      for (Vertex next : adjacent_[cur]) {
+        if (Relax(cur, next)) {
+          vertices.push(next);
+        }
+      }
+    }
+  }
+
+  bool Erase(Vertex from, Vertex to) {
+    auto& list = adjacent_[from];
+    auto found = std::find(list.begin(), list.end(), to);
+    if (found == list.end()) {
+      return false;
+    }
+    *found = list.back();
+    list.pop_back();
+    return true;
+  }
+
+  // Ищет другого соседа на предыдущем слое, не затронутого удалением.
+  bool Reattach(Vertex vertex) {
+    for (Vertex next : adjacent_[vertex]) {
+      if (!affected_[next] && (dist_[next] != kInfinity) &&
+          (dist_[next] + 1 == dist_[vertex])) {
+        parents_[vertex] = next;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Repair(Vertex root) {
+    if (Reattach(root)) {
+      return;
+    }
+    // Затронутые вершины: поддерево, потерявшее все кратчайшие пути.
+    std::vector<Vertex> affected{root};
+    affected_[root] = true;
+    for (size_t i = 0; i < affected.size(); ++i) {
+      Vertex cur = affected[i];
+      for (Vertex next : adjacent_[cur]) {
+        if (!affected_[next] && (parents_[next] == cur) && !Reattach(next)) {
+          affected_[next] = true;
+          affected.push_back(next);
+        }
+      }
+    }
+    // Новые расстояния: сначала через незатронутых соседей, затем внутри.
+    using QueueItem = std::pair<Vertex, Vertex>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>,
+                        std::greater<QueueItem>>
+        queue;
+    for (Vertex cur : affected) {
+      dist_[cur] = kInfinity;
+      parents_[cur] = kInfinity;
+      for (Vertex next : adjacent_[cur]) {
+        if (!affected_[next]) {
+          Relax(next, cur);
+        }
+      }
+      if (dist_[cur] != kInfinity) {
+        queue.push({dist_[cur], cur});
+      }
+    }
+    while (!queue.empty()) {
+      auto [dist, cur] = queue.top();
+      queue.pop();
+      if (dist != dist_[cur]) {
+        continue;
+      }
+      for (Vertex next : adjacent_[cur]) {
+        if (affected_[next] && Relax(cur, next)) {
+          queue.push({dist_[next], next});
+        }
+      }
+    }
+    for (Vertex cur : affected) {
+      affected_[cur] = false;
+    }
+  }
+
+  std::vector<std::vector<Vertex>> adjacent_;
+  std::vector<Vertex> dist_;
+  std::vector<Vertex> parents_;
+  std::vector<bool> affected_;
+  Vertex source_;
+};
+
+// Расстояния между всеми парами вершин. BFS запускается сразу из kBatchSize
+// источников: множество источников, уже достигших вершины, хранится битовой
+// маской, и один проход по рёбрам продвигает на уровень все обходы пачки.
+// Граф неориентированный, поэтому строка вершины v заполняется расстояниями
+// от источников пачки подряд. Вершины -- числа из [0, n).
+template <typename Graph>
+class AllPairsDistances {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using Distance = uint16_t;
+
+  static constexpr Distance kUnreachable = std::numeric_limits<Distance>::max();
+
+  AllPairsDistances(const Graph& graph, size_t num_threads = 1)
+      : graph_(graph), num_vertices_(graph.VerticesCount()) {
+    if (num_vertices_ >= kUnreachable) {
+      throw std::length_error("graph is too large for the distance matrix");
+    }
+    distances_.assign(num_vertices_ * num_vertices_, kUnreachable);
+    size_t num_batches = (num_vertices_ + kBatchSize - 1) / kBatchSize;
+    std::atomic<size_t> next_batch = 0;
+    auto worker = [&]() {
+      BatchState state(num_vertices_);
+      for (size_t batch = next_batch++; batch < num_batches;
+           batch = next_batch++) {
+        RunBatch(batch * kBatchSize, state);
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(num_threads, num_batches); ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+      thread.join();
+    }
+  }
+
+  Distance operator()(VertexType first, VertexType second) const {
+    return distances_[first * num_vertices_ + second];
+  }
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  bool WriteTo(const char* path) const {
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    size_t written = std::fwrite(distances_.data(), sizeof(Distance),
+                                 distances_.size(), file);
+    return (std::fclose(file) == 0) && (written == distances_.size());
+  }
+
+ private:
+  static constexpr size_t kWordBits = 64;
+  static constexpr size_t kWords = 4;
+  static constexpr size_t kBatchSize = kWordBits * kWords;
+
+  // Ширина маски фиксирована, так что циклы по словам разворачиваются
+  // компилятором в векторные инструкции.
+  using Mask = std::array<uint64_t, kWords>;
+
+  struct BatchState {
+    explicit BatchState(size_t num_vertices)
+        : visited(num_vertices), frontier(num_vertices), next(num_vertices) {}
+
+    std::vector<Mask> visited;
+    std::vector<Mask> frontier;
+    std::vector<Mask> next;
+  };
+
+  void RunBatch(size_t first_source, BatchState& state) {
+    size_t count = std::min(kBatchSize, num_vertices_ - first_source);
+    std::fill(state.visited.begin(), state.visited.end(), Mask{});
+    std::fill(state.frontier.begin(), state.frontier.end(), Mask{});
+    Mask full{};
+    for (size_t i = 0; i < count; ++i) {
+      size_t source = first_source + i;
+      full[i / kWordBits] |= uint64_t{1} << (i % kWordBits);
+      state.visited[source][i / kWordBits] |= uint64_t{1} << (i % kWordBits);
+      state.frontier[source] = state.visited[source];
+      distances_[source * num_vertices_ + source] = 0;
+    }
+    bool advanced = true;
+    for (Distance level = 1; advanced; ++level) {
+      advanced = false;
+      for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+        Mask& fresh = state.next[vertex];
+        fresh = Mask{};
+        if (state.visited[vertex] == full) {
+          continue;
+        }
+        for (VertexType next : graph_.GetNeighbours(vertex)) {
+          for (size_t word = 0; word < kWords; ++word) {
+            fresh[word] |= state.frontier[next][word];
+          }
+        }
+        bool any = false;
+        for (size_t word = 0; word < kWords; ++word) {
+          fresh[word] &= ~state.visited[vertex][word];
+          state.visited[vertex][word] |= fresh[word];
+          any |= (fresh[word] != 0);
+        }
+        if (!any) {
+          continue;
+        }
+        advanced = true;
+        Distance* row = &distances_[vertex * num_vertices_ + first_source];
+        for (size_t word = 0; word < kWords; ++word) {
+          for (uint64_t bits = fresh[word]; bits != 0; bits &= bits - 1) {
+            row[word * kWordBits + std::countr_zero(bits)] = level;
+          }
+        }
+      }
+      std::swap(state.frontier, state.next);
+    }
+  }
+
+  const Graph& graph_;
+  size_t num_vertices_;
+  std::vector<Distance> distances_;
+};
+
+// Вершинно-ориентированный движок в стиле Pregel. На каждом супершаге
+// Program::Compute вызывается для вершин, которые получили сообщение или не
+// проголосовали за остановку. Сообщения одной вершине сразу сливаются
+// комбинатором в атомарной ячейке следующего буфера, буферы меняются местами
+// между супершагами. Program::kIdentity -- нейтральный элемент комбинатора,
+// он же означает отсутствие сообщения. Вершины -- числа из [0, n).
+template <typename Graph, typename Program>
+class PregelEngine {
+ public:
+  using Value = typename Program::Value;
+  using Message = typename Program::Message;
+
+  class Context {
+   public:
+    const Graph& GetGraph() const { return engine_.graph_; }
+
+    size_t Superstep() const { return engine_.superstep_; }
+
+    void SendMessage(size_t vertex, Message message) {
+      engine_.Send(vertex, message);
+    }
+
+   private:
+    friend class PregelEngine;
+
+    explicit Context(PregelEngine& engine) : engine_(engine) {}
+
+    PregelEngine& engine_;
+  };
+
+  PregelEngine(const Graph& graph, const Program& program,
+               size_t num_threads = 1)
+      : graph_(graph),
+        program_(program),
+        num_threads_(std::max<size_t>(1, num_threads)),
+        values_(graph.VerticesCount()),
+        active_(graph.VerticesCount(), 1),
+        inbox_(graph.VerticesCount()),
+        outbox_(graph.VerticesCount()) {
+    for (size_t vertex = 0; vertex < values_.size(); ++vertex) {
+      values_[vertex] = program_.Initialize(vertex);
+      inbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+      outbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+    }
+  }
+
+  const std::vector<Value>& operator()() {
+    std::barrier sync(num_threads_, [this]() noexcept { FinishSuperstep(); });
+    auto worker = [this, &sync]() {
+      Context context(*this);
+      while (!done_) {
+        for (size_t begin = NextBlock(); begin < values_.size();
+             begin = NextBlock()) {
+          size_t end = std::min(values_.size(), begin + kBlockSize);
+          for (size_t vertex = begin; vertex < end; ++vertex) {
+            ComputeVertex(vertex, context);
+          }
+        }
+        sync.arrive_and_wait();
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_threads_; ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+      thread.join();
+    }
+    return values_;
+  }
+
+  size_t SuperstepsCount() const { return superstep_; }
+
+ private:
+  static constexpr size_t kBlockSize = 1024;
+
+  size_t NextBlock() {
+    return next_block_.fetch_add(kBlockSize, std::memory_order_relaxed);
+  }
+
+  void ComputeVertex(size_t vertex, Context& context) {
+    Message message =
+        inbox_[vertex].exchange(Program::kIdentity, std::memory_order_relaxed);
+    if ((active_[vertex] == 0) && (message == Program::kIdentity)) {
+      return;
+    }
+    active_[vertex] =
+        program_.Compute(vertex, values_[vertex], message, context) ? 1 : 0;
+    if (active_[vertex] != 0) {
+      MarkProgress();
+    }
+  }
+
+  void Send(size_t vertex, Message message) {
+    MarkProgress();
+    std::atomic<Message>& cell = outbox_[vertex];
+    Message current = cell.load(std::memory_order_relaxed);
+    Message combined = Program::Combine(current, message);
+    while ((combined != current) &&
+           !cell.compare_exchange_weak(current, combined,
+                                       std::memory_order_relaxed)) {
+      combined = Program::Combine(current, message);
+    }
+  }
+
+  void MarkProgress() {
+    if (!progress_.load(std::memory_order_relaxed)) {
+      progress_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Выполняется одним потоком, когда все дошли до барьера.
+  void FinishSuperstep() {
+    std::swap(inbox_, outbox_);
+    ++superstep_;
+    next_block_.store(0, std::memory_order_relaxed);
+    done_ = !progress_.exchange(false, std::memory_order_relaxed);
+  }
+
+  const Graph& graph_;
+  Program program_;
+  size_t num_threads_;
+  std::vector<Value> values_;
+  std::vector<uint8_t> active_;
+  std::vector<std::atomic<Message>> inbox_;
+  std::vector<std::atomic<Message>> outbox_;
+  std::atomic<size_t> next_block_ = 0;
+  std::atomic<bool> progress_ = false;
+  size_t superstep_ = 0;
+  bool done_ = false;
+};
+
+// BFS от одного источника: значение вершины -- упакованные расстояние и
+// предок, так что комбинатор-минимум оставляет кратчайшее расстояние.
+struct HopDistanceProgram {
+  using Value = uint64_t;
+  using Message = uint64_t;
+
+  static constexpr Message kIdentity = std::numeric_limits<Message>::max();
+  static constexpr size_t kParentBits = 32;
+  static constexpr Message kParentMask = (Message{1} << kParentBits) - 1;
+
+  static Message Combine(Message first, Message second) {
+    return std::min(first, second);
+  }
+
+  Value Initialize(size_t /*vertex*/) const { return kIdentity; }
+
+  template <typename Context>
+  bool Compute(size_t vertex, Value& value, Message message,
+               Context& context) const {
+    if ((context.Superstep() == 0) && (vertex == source)) {
+      message = vertex;
+    }
+    if (message >= value) {
+      return false;
+    }
+    value = message;
+    Message next = (((value >> kParentBits) + 1) << kParentBits) | vertex;
+    for (auto adj : context.GetGraph().GetNeighbours(vertex)) {
+      context.SendMessage(adj, next);
+    }
+    return false;
+  }
+
+  size_t source;
+};
+
+template <typename Graph>
+std::vector<size_t> FindPath(const Graph& graph, size_t start, size_t finish,
+                             size_t num_threads) {
+  PregelEngine<Graph, HopDistanceProgram> engine(
+      graph, HopDistanceProgram{start}, num_threads);
+  const std::vector<uint64_t>& values = engine();
+  if (values[finish] == HopDistanceProgram::kIdentity) {
+    return {};
+  }
+  std::vector<size_t> res{finish};
+  while (res.back() != start) {
+    res.push_back(values[res.back()] & HopDistanceProgram::kParentMask);
+  }
+  std::reverse(res.begin(), res.end());
+  return res;
+}
+
+void PrintPath(const std::vector<size_t>& path) {
   if (path.empty()) {
     std::cout << "-1" << std::endl;
-    return 0;
+    return;
   }
   std::cout << (path.size() - 1) << std::endl;
   for (size_t planet : path) {
     std::cout << planet << " ";
   }
   std::cout << std::endl;
+}
+
+std::vector<std::pair<size_t, size_t>> ReadEdges(size_t num_edges) {
+  std::vector<std::pair<size_t, size_t>> edges(num_edges);
+  for (size_t i = 0; i < num_edges; ++i) {
+    std::cin >> edges[i].first >> edges[i].second;
+  }
+  return edges;
+}
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
+  if ((mode == "--semi-external") && (argc > 2)) {
+    size_t num_vertices;
+    size_t start;
+    size_t finish;
+    std::cin >> num_vertices >> start >> finish;
+    SemiExternalBFS finder(argv[2], num_vertices + 1);
+    finder(start, finish);
+    PrintPath(finder.GetPath(start, finish));
+    return 0;
+  }
+  size_t num_vertices;
+  size_t num_edges;
+  std::cin >> num_vertices >> num_edges;
+  if (mode == "--queries") {
+    constexpr size_t kDefaultCacheMegabytes = 256;
+    size_t memory_limit =
+        ((argc > 2) ? std::stoull(argv[2]) : kDefaultCacheMegabytes) << 20;
+    CompressedGraph<> graph(num_vertices + 1, ReadEdges(num_edges));
+    PathQueryCache<CompressedGraph<>> cache(graph, memory_limit);
+    size_t num_queries;
+    std::cin >> num_queries;
+    for (size_t i = 0; i < num_queries; ++i) {
+      size_t start;
+      size_t finish;
+      std::cin >> start >> finish;
+      PrintPath(cache.GetPath(start, finish));
+    }
+    std::cerr << "hits: " << cache.Hits() << " misses: " << cache.Misses()
+              << std::endl;
+    return 0;
+  }
+  if (mode == "--all-pairs") {
+    CompressedGraph<> graph(num_vertices + 1, ReadEdges(num_edges));
+    AllPairsDistances<CompressedGraph<>> distances(
+        graph, std::max(1U, std::thread::hardware_concurrency()));
+    if (argc > 2) {
+      if (!distances.WriteTo(argv[2])) {
+        std::cerr << "cannot write " << argv[2] << std::endl;
+        return 1;
+      }
+      return 0;
+    }
+    for (size_t first = 1; first <= num_vertices; ++first) {
+      for (size_t second = 1; second <= num_vertices; ++second) {
+        auto distance = distances(first, second);
+        if (distance == distances.kUnreachable) {
+          std::cout << "-1 ";
+        } else {
+          std::cout << distance << " ";
+        }
+      }
+      std::cout << std::endl;
+    }
+    return 0;
+  }
+  size_t start;
+  size_t finish;
+  std::cin >> start >> finish;
+  if ((mode == "--make-edge-file") && (argc > 2)) {
+    auto read_edge = []() {
+      std::pair<size_t, size_t> edge;
+      std::cin >> edge.first >> edge.second;
+      return edge;
+    };
+    if (!WriteEdgeFile(argv[2], num_edges, read_edge)) {
+      std::cerr << "cannot write " << argv[2] << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+  auto edges = ReadEdges(num_edges);
+  if (mode == "--dynamic") {
+    DynamicBFS<> distances(num_vertices + 1, edges, start);
+    char operation;
+    while (std::cin >> operation) {
+      size_t first;
+      std::cin >> first;
+      if (operation == '?') {
+        PrintPath(distances.GetPath(first));
+        continue;
+      }
+      size_t second;
+      std::cin >> second;
+      if (operation == '+') {
+        distances.InsertEdge(first, second);
+      } else if (operation == '-') {
+        distances.DeleteEdge(first, second);
+      }
+    }
+    return 0;
+  }
+  if (mode == "--diameter") {
+    CompressedGraph<> graph(num_vertices + 1, edges);
+    EccentricityFinder<CompressedGraph<>> finder(graph);
+    size_t diameter = finder.Diameter(start);
+    size_t diameter_runs = finder.RunsCount();
+    size_t radius = finder.Radius(start);
+    std::cout << diameter << " " << radius << std::endl;
+    std::cerr << "bfs runs: " << diameter_runs << " for the diameter, "
+              << (finder.RunsCount() - diameter_runs) << " for the radius"
+              << std::endl;
+    return 0;
+  }
+  CompressedGraph<> graph(num_vertices + 1, edges);
+  BFS<CompressedGraph<>, ParentVisitor<>> finder(graph);
+  size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                  : std::thread::hardware_concurrency();
+  if (mode == "--pregel") {
+    PrintPath(FindPath(graph, start, finish, num_threads));
+    return 0;
+  }
+  if (mode == "--bench") {
+    auto begin = std::chrono::steady_clock::now();
+    auto sequential = FindPath(finder, start, finish);
+    auto middle = std::chrono::steady_clock::now();
+    auto parallel = FindPath(graph, start, finish, num_threads);
+    auto end = std::chrono::steady_clock::now();
+    std::cerr << "sequential: "
+              << std::chrono::duration<double, std::milli>(middle - begin)
+                     .count()
+              << " ms, pregel (" << num_threads << " threads): "
+              << std::chrono::duration<double, std::milli>(end - middle)
+                     .count()
+              << " ms"
+              << (sequential.size() == parallel.size() ? "" : ", MISMATCH")
+              << std::endl;
+    PrintPath(parallel);
+    return 0;
+  }
+  PrintPath(FindPath(finder, start, finish));
   return 0;
 }
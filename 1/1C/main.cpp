@@ -1,10 +1,18 @@
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <list>
+#include <map>
 #include <optional>
 #include <queue>
+#include <span>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -138,6 +146,82 @@ class TopologicalSorter : public Visitor<Vertex, Edge> {
   bool sort_exists_ = true;
 };
 
+// Ленивый генератор на корутинах: значения вычисляются по мере обхода,
+// а прерванный цикл сразу освобождает состояние корутины.
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    const T* value = nullptr;
+
+    Generator get_return_object() {
+      return Generator{Handle::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(const T& item) {
+      value = std::addressof(item);
+      return {};
+    }
+
+    void return_void() {}
+
+    void unhandled_exception() { throw; }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  struct Sentinel {};
+
+  class Iterator {
+   public:
+    explicit Iterator(Handle handle) : handle_(handle) {}
+
+    Iterator& operator++() {
+      handle_.resume();
+      return *this;
+    }
+
+    const T& operator*() const { return *handle_.promise().value; }
+
+    bool operator==(Sentinel /*unused*/) const { return handle_.done(); }
+
+    bool operator!=(Sentinel /*unused*/) const { return !handle_.done(); }
+
+   private:
+    Handle handle_;
+  };
+
+  explicit Generator(Handle handle) : handle_(handle) {}
+
+  Generator(Generator&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+
+  ~Generator() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  // NOLINTNEXTLINE
+  Iterator begin() {
+    handle_.resume();
+    return Iterator(handle_);
+  }
+
+  // NOLINTNEXTLINE
+  Sentinel end() const { return {}; }
+
+ private:
+  Handle handle_;
+};
+
 template <typename Graph, typename Visitor>
 class DFS {
   enum class VertexColor { WHITE, GRAY, BLACK };
@@ -158,6 +242,43 @@ class DFS {
     }
   }
 
+  // Вершины в порядке входа DFS; обход итеративный, поэтому его можно
+  // прервать в любой момент. DFS должен пережить генератор.
+  Generator<typename Graph::VertexType> Vertices() const {
+    // Соседи копируются в вектор и обходятся по индексу: при росте стека
+    // кадры переезжают, и итераторы в них были бы недействительны.
+    std::unordered_set<typename Graph::VertexType> discovered;
+    std::vector<std::pair<std::vector<typename Graph::VertexType>, size_t>>
+        stack;
+    auto push = [&](const typename Graph::VertexType& vertex) {
+      auto neighbours = graph_.GetNeighbours(vertex);
+      stack.emplace_back(
+          std::vector<typename Graph::VertexType>(neighbours.begin(),
+                                                  neighbours.end()),
+          0);
+    };
+    for (auto root : graph_.GetVertices()) {
+      if (!discovered.insert(root).second) {
+        continue;
+      }
+      co_yield root;
+      push(root);
+      while (!stack.empty()) {
+        auto& [neighbours, pos] = stack.back();
+        if (pos == neighbours.size()) {
+          stack.pop_back();
+          continue;
+        }
+        auto next = neighbours[pos++];
+        if (!discovered.insert(next).second) {
+          continue;
+        }
+        co_yield next;
+        push(next);
+      }
+    }
+  }
+
   const Visitor& GetVisitor() const { return visitor_; }
 
  private:
@@ -188,7 +309,341 @@ class DFS {
   std::unordered_map<typename Graph::VertexType, VertexColor> colors_;
 };
 
-int main() {
+// Вершины DAG, перенумерованные позициями в топологическом порядке, и
+// рёбра между позициями в плоских массивах.
+template <typename Graph>
+class TopologicalLayout {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  template <typename Order>
+  TopologicalLayout(const Graph& graph, const Order& order) {
+    for (const auto& vertex : order) {
+      positions_[vertex] = vertices_.size();
+      vertices_.push_back(vertex);
+    }
+    offsets_.push_back(0);
+    for (const auto& vertex : vertices_) {
+      for (const auto& next : graph.GetNeighbours(vertex)) {
+        children_.push_back(positions_.at(next));
+      }
+      offsets_.push_back(children_.size());
+    }
+  }
+
+  size_t Size() const { return vertices_.size(); }
+
+  size_t Position(const VertexType& vertex) const {
+    return positions_.at(vertex);
+  }
+
+  const VertexType& GetVertex(size_t position) const {
+    return vertices_[position];
+  }
+
+  std::span<const size_t> Children(size_t position) const {
+    return {children_.data() + offsets_[position],
+            children_.data() + offsets_[position + 1]};
+  }
+
+ private:
+  std::unordered_map<VertexType, size_t> positions_;
+  std::vector<VertexType> vertices_;
+  std::vector<size_t> offsets_;
+  std::vector<size_t> children_;
+};
+
+// Индекс достижимости: для каждой вершины -- битовое множество потомков,
+// собранное в обратном топологическом порядке. Потомки стоят в порядке
+// позже вершины, поэтому строка хранится только начиная с её слова: строки
+// лежат треугольником подряд, row_offsets_ -- начало каждой строки.
+template <typename Graph>
+class ReachabilityIndex {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  template <typename Order>
+  ReachabilityIndex(const Graph& graph, const Order& order)
+      : layout_(graph, order),
+        words_((layout_.Size() + kWordBits - 1) / kWordBits),
+        row_offsets_(layout_.Size() + 1, 0) {
+    for (size_t pos = 0; pos < layout_.Size(); ++pos) {
+      row_offsets_[pos + 1] = row_offsets_[pos] + words_ - pos / kWordBits;
+    }
+    bits_.assign(row_offsets_.back(), 0);
+    for (size_t pos = layout_.Size(); pos-- > 0;) {
+      bits_[Word(pos, pos / kWordBits)] |= uint64_t{1} << (pos % kWordBits);
+      for (size_t child : layout_.Children(pos)) {
+        for (size_t word = child / kWordBits; word < words_; ++word) {
+          bits_[Word(pos, word)] |= bits_[Word(child, word)];
+        }
+      }
+    }
+  }
+
+  bool Reaches(const VertexType& from, const VertexType& to) const {
+    size_t from_pos = layout_.Position(from);
+    size_t to_pos = layout_.Position(to);
+    if (to_pos < from_pos) {
+      return false;
+    }
+    return ((bits_[Word(from_pos, to_pos / kWordBits)] >>
+             (to_pos % kWordBits)) &
+            1) != 0;
+  }
+
+ private:
+  static constexpr size_t kWordBits = 64;
+
+  // Номер слова word строки pos; word не меньше pos / kWordBits.
+  size_t Word(size_t pos, size_t word) const {
+    return row_offsets_[pos] + word - pos / kWordBits;
+  }
+
+  TopologicalLayout<Graph> layout_;
+  size_t words_;
+  std::vector<size_t> row_offsets_;
+  std::vector<uint64_t> bits_;
+};
+
+// Тот же индекс для больших n: целевые вершины разбиваются на отрезки по
+// slab_size позиций, и за раз строятся битовые множества только для одного
+// отрезка. Запросы отвечаются пачкой.
+template <typename Graph>
+class ChunkedReachability {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  template <typename Order>
+  ChunkedReachability(const Graph& graph, const Order& order, size_t slab_size)
+      : layout_(graph, order),
+        slab_words_(std::max<size_t>(1, (slab_size + kWordBits - 1) /
+                                            kWordBits)) {}
+
+  std::vector<bool> Answer(
+      const std::vector<std::pair<VertexType, VertexType>>& queries) const {
+    const size_t slab_size = slab_words_ * kWordBits;
+    const size_t num_slabs = (layout_.Size() + slab_size - 1) / slab_size;
+    std::vector<std::vector<size_t>> by_slab(num_slabs);
+    std::vector<bool> res(queries.size(), false);
+    for (size_t i = 0; i < queries.size(); ++i) {
+      size_t from_pos = layout_.Position(queries[i].first);
+      size_t to_pos = layout_.Position(queries[i].second);
+      if (from_pos <= to_pos) {
+        by_slab[to_pos / slab_size].push_back(i);
+      }
+    }
+    std::vector<uint64_t> bits;
+    for (size_t slab = 0; slab < num_slabs; ++slab) {
+      if (by_slab[slab].empty()) {
+        continue;
+      }
+      size_t low = slab * slab_size;
+      size_t high = std::min(layout_.Size(), low + slab_size);
+      bits.assign(high * slab_words_, 0);
+      for (size_t pos = high; pos-- > 0;) {
+        uint64_t* row = bits.data() + pos * slab_words_;
+        if (pos >= low) {
+          row[(pos - low) / kWordBits] |= uint64_t{1}
+                                          << ((pos - low) % kWordBits);
+        }
+        for (size_t child : layout_.Children(pos)) {
+          if (child >= high) {
+            continue;
+          }
+          const uint64_t* child_row = bits.data() + child * slab_words_;
+          for (size_t word = 0; word < slab_words_; ++word) {
+            row[word] |= child_row[word];
+          }
+        }
+      }
+      for (size_t i : by_slab[slab]) {
+        size_t from_pos = layout_.Position(queries[i].first);
+        size_t to_pos = layout_.Position(queries[i].second) - low;
+        res[i] = ((bits[from_pos * slab_words_ + to_pos / kWordBits] >>
+                   (to_pos % kWordBits)) &
+                  1) != 0;
+      }
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kWordBits = 64;
+
+  TopologicalLayout<Graph> layout_;
+  size_t slab_words_;
+};
+
+// Критический путь по топологическому порядку: ранние и поздние сроки
+// начала и резерв для задач с длительностями и задержками на рёбрах.
+// Параллельный вариант обрабатывает по очереди топологические уровни.
+template <typename Graph, typename Weight = int64_t>
+class CriticalPathEngine {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  template <typename Order, typename Durations, typename EdgeWeight>
+  CriticalPathEngine(const Graph& graph, const Order& order,
+                     const Durations& durations, EdgeWeight edge_weight)
+      : layout_(graph, order),
+        durations_(layout_.Size()),
+        offsets_(layout_.Size() + 1, 0) {
+    for (size_t pos = 0; pos < layout_.Size(); ++pos) {
+      durations_[pos] = durations(layout_.GetVertex(pos));
+      for (size_t child : layout_.Children(pos)) {
+        weights_.push_back(
+            edge_weight(layout_.GetVertex(pos), layout_.GetVertex(child)));
+      }
+      offsets_[pos + 1] = weights_.size();
+    }
+  }
+
+  void operator()() {
+    const size_t size = layout_.Size();
+    earliest_.assign(size, 0);
+    for (size_t pos = 0; pos < size; ++pos) {
+      size_t edge = offsets_[pos];
+      for (size_t child : layout_.Children(pos)) {
+        earliest_[child] =
+            std::max(earliest_[child],
+                     earliest_[pos] + durations_[pos] + weights_[edge++]);
+      }
+    }
+    ComputeLength();
+    latest_.resize(size);
+    for (size_t pos = size; pos-- > 0;) {
+      latest_[pos] = ComputeLatest(pos);
+    }
+  }
+
+  void operator()(size_t num_threads) {
+    BuildLevels();
+    const size_t size = layout_.Size();
+    earliest_.assign(size, 0);
+    for (const auto& level : levels_) {
+      ParallelFor(level.size(), num_threads, [&](size_t i) {
+        size_t pos = level[i];
+        for (size_t edge = parent_offsets_[pos];
+             edge < parent_offsets_[pos + 1]; ++edge) {
+          size_t parent = parents_[edge];
+          earliest_[pos] =
+              std::max(earliest_[pos], earliest_[parent] + durations_[parent] +
+                                           weights_[parent_edges_[edge]]);
+        }
+      });
+    }
+    ComputeLength();
+    latest_.resize(size);
+    for (auto level = levels_.rbegin(); level != levels_.rend(); ++level) {
+      ParallelFor(level->size(), num_threads, [&](size_t i) {
+        latest_[(*level)[i]] = ComputeLatest((*level)[i]);
+      });
+    }
+  }
+
+  Weight Length() const { return length_; }
+
+  Weight Earliest(const VertexType& vertex) const {
+    return earliest_[layout_.Position(vertex)];
+  }
+
+  Weight Latest(const VertexType& vertex) const {
+    return latest_[layout_.Position(vertex)];
+  }
+
+  Weight Slack(const VertexType& vertex) const {
+    return Latest(vertex) - Earliest(vertex);
+  }
+
+ private:
+  static constexpr size_t kMinParallelLevel = 1024;
+
+  template <typename Body>
+  static void ParallelFor(size_t count, size_t num_threads, Body body) {
+    if ((num_threads <= 1) || (count < kMinParallelLevel)) {
+      for (size_t i = 0; i < count; ++i) {
+        body(i);
+      }
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+      size_t end = std::min(count, begin + chunk);
+      workers.emplace_back([begin, end, &body] {
+        for (size_t i = begin; i < end; ++i) {
+          body(i);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  void ComputeLength() {
+    length_ = 0;
+    for (size_t pos = 0; pos < layout_.Size(); ++pos) {
+      length_ = std::max(length_, earliest_[pos] + durations_[pos]);
+    }
+  }
+
+  Weight ComputeLatest(size_t pos) const {
+    Weight finish = length_;
+    size_t edge = offsets_[pos];
+    for (size_t child : layout_.Children(pos)) {
+      finish = std::min(finish, latest_[child] - weights_[edge++]);
+    }
+    return finish - durations_[pos];
+  }
+
+  void BuildLevels() {
+    if (!levels_.empty() || (layout_.Size() == 0)) {
+      return;
+    }
+    const size_t size = layout_.Size();
+    std::vector<size_t> level(size, 0);
+    parent_offsets_.assign(size + 1, 0);
+    for (size_t pos = 0; pos < size; ++pos) {
+      for (size_t child : layout_.Children(pos)) {
+        level[child] = std::max(level[child], level[pos] + 1);
+        ++parent_offsets_[child + 1];
+      }
+    }
+    for (size_t pos = 0; pos < size; ++pos) {
+      parent_offsets_[pos + 1] += parent_offsets_[pos];
+    }
+    parents_.resize(parent_offsets_[size]);
+    parent_edges_.resize(parent_offsets_[size]);
+    std::vector<size_t> fill(parent_offsets_.begin(),
+                             parent_offsets_.end() - 1);
+    levels_.resize(*std::max_element(level.begin(), level.end()) + 1);
+    for (size_t pos = 0; pos < size; ++pos) {
+      levels_[level[pos]].push_back(pos);
+      size_t edge = offsets_[pos];
+      for (size_t child : layout_.Children(pos)) {
+        parents_[fill[child]] = pos;
+        parent_edges_[fill[child]++] = edge++;
+      }
+    }
+  }
+
+  TopologicalLayout<Graph> layout_;
+  std::vector<Weight> durations_;
+  std::vector<size_t> offsets_;
+  std::vector<Weight> weights_;
+  std::vector<std::vector<size_t>> levels_;
+  std::vector<size_t> parent_offsets_;
+  std::vector<size_t> parents_;
+  std::vector<size_t> parent_edges_;
+  std::vector<Weight> earliest_;
+  std::vector<Weight> latest_;
+  Weight length_ = 0;
+};
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   size_t num_vertices, num_edges;
   std::cin >> num_vertices >> num_edges;
   std::vector<size_t> vertices(num_vertices);
@@ -196,15 +651,72 @@ int main() {
     vertices[i] = i + 1;
   }
   std::vector<std::pair<size_t, size_t>> edges(num_edges);
+  std::map<std::pair<size_t, size_t>, int64_t> lags;
   for (size_t i = 0; i < num_edges; ++i) {
     std::cin >> edges[i].first >> edges[i].second;
+    if (mode == "--schedule") {
+      int64_t lag;
+      std::cin >> lag;
+      auto [iter, inserted] = lags.insert({edges[i], lag});
+      iter->second = std::max(iter->second, lag);
+    }
   }
   DirectedGraph<> graph(vertices, edges);
   DFS<decltype(graph), TopologicalSorter<>> topsort(graph);
+  if (mode == "--preorder") {
+    size_t limit = (argc > 2) ? std::stoull(argv[2]) : num_vertices;
+    for (auto vertex : topsort.Vertices()) {
+      if (limit-- == 0) {
+        break;
+      }
+      std::cout << vertex << " ";
+    }
+    std::cout << std::endl;
+    return 0;
+  }
   topsort();
   auto res = topsort.GetVisitor().SortResult();
   if (!res.has_value()) {
     std::cout << -1 << std::endl;
+  } else if (mode == "--schedule") {
+    std::vector<int64_t> durations(num_vertices + 1);
+    for (size_t vertex = 1; vertex <= num_vertices; ++vertex) {
+      std::cin >> durations[vertex];
+    }
+    CriticalPathEngine<decltype(graph)> schedule(
+        graph, *res, [&](size_t vertex) { return durations[vertex]; },
+        [&](size_t from, size_t to) { return lags.at({from, to}); });
+    if (argc > 2) {
+      schedule(std::stoull(argv[2]));
+    } else {
+      schedule();
+    }
+    std::cout << schedule.Length() << '\n';
+    for (size_t vertex = 1; vertex <= num_vertices; ++vertex) {
+      std::cout << schedule.Earliest(vertex) << " " << schedule.Latest(vertex)
+                << " " << schedule.Slack(vertex) << '\n';
+    }
+  } else if (mode == "--reach") {
+    size_t num_queries;
+    std::cin >> num_queries;
+    std::vector<std::pair<size_t, size_t>> queries(num_queries);
+    for (auto& query : queries) {
+      std::cin >> query.first >> query.second;
+    }
+    std::vector<bool> answers(num_queries);
+    if (argc > 2) {
+      ChunkedReachability<decltype(graph)> index(graph, *res,
+                                                 std::stoull(argv[2]));
+      answers = index.Answer(queries);
+    } else {
+      ReachabilityIndex<decltype(graph)> index(graph, *res);
+      for (size_t i = 0; i < num_queries; ++i) {
+        answers[i] = index.Reaches(queries[i].first, queries[i].second);
+      }
+    }
+    for (bool answer : answers) {
+      std::cout << (answer ? "YES" : "NO") << '\n';
+    }
   } else {
     for (auto vertex : *res) {
       std::cout << vertex << " ";
@@ -1,9 +1,143 @@
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <queue>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
-std::vector<size_t> BFS(const std::vector<std::vector<size_t>>& graph,
-                        size_t start, std::vector<bool>& used) {
+// Отсортированные списки соседей хранятся разностями в varint-кодировке
+// и декодируются прямо во время обхода.
+class CompressedGraph {
+ public:
+  class NeighbourIterator {
+   public:
+    NeighbourIterator(const uint8_t* pos, const uint8_t* end)
+        : pos_(pos), next_(pos), end_(end) {
+      Decode();
+    }
+
+    NeighbourIterator& operator++() {
+      pos_ = next_;
+      Decode();
+      return *this;
+    }
+
+    bool operator==(const NeighbourIterator& other) const {
+      return pos_ == other.pos_;
+    }
+
+    bool operator!=(const NeighbourIterator& other) const {
+      return pos_ != other.pos_;
+    }
+
+    size_t operator*() const { return value_; }
+
+   private:
+    void Decode() {
+      if (pos_ == end_) {
+        return;
+      }
+      size_t gap = 0;
+      size_t shift = 0;
+      while ((*next_ & kContinuation) != 0) {
+        gap |= static_cast<size_t>(*next_++ & kPayload) << shift;
+        shift += kPayloadBits;
+      }
+      gap |= static_cast<size_t>(*next_++) << shift;
+      value_ += gap;
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* next_;
+    const uint8_t* end_;
+    size_t value_ = 0;
+  };
+
+  class NeighbourRange {
+   public:
+    NeighbourRange(const uint8_t* begin, const uint8_t* end)
+        : begin_(begin), end_(end) {}
+
+    // NOLINTNEXTLINE
+    NeighbourIterator begin() const { return {begin_, end_}; }
+
+    // NOLINTNEXTLINE
+    NeighbourIterator end() const { return {end_, end_}; }
+
+   private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+  };
+
+  CompressedGraph(size_t num_vertices,
+                  const std::vector<std::pair<size_t, size_t>>& edges)
+      : offsets_(num_vertices + 1, 0) {
+    std::vector<size_t> starts(num_vertices + 1, 0);
+    for (auto edge : edges) {
+      ++starts[edge.first];
+      ++starts[edge.second];
+    }
+    size_t total = 0;
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      std::swap(starts[vertex], total);
+      total += starts[vertex];
+    }
+    starts[num_vertices] = total;
+    std::vector<size_t> neighbours(total);
+    std::vector<size_t> fill(starts.begin(), starts.end() - 1);
+    for (auto edge : edges) {
+      neighbours[fill[edge.first]++] = edge.second;
+      neighbours[fill[edge.second]++] = edge.first;
+    }
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      auto first = neighbours.begin() + starts[vertex];
+      auto last = neighbours.begin() + starts[vertex + 1];
+      std::sort(first, last);
+      size_t prev = 0;
+      for (auto iter = first; iter != last; ++iter) {
+        Encode(*iter - prev);
+        prev = *iter;
+      }
+      offsets_[vertex + 1] = data_.size();
+    }
+    data_.shrink_to_fit();
+  }
+
+  size_t VerticesCount() const { return offsets_.size() - 1; }
+
+  NeighbourRange GetNeighbours(size_t vertex) const {
+    return {data_.data() + offsets_[vertex],
+            data_.data() + offsets_[vertex + 1]};
+  }
+
+ private:
+  void Encode(size_t gap) {
+    while (gap > kPayload) {
+      data_.push_back(static_cast<uint8_t>(gap & kPayload) | kContinuation);
+      gap >>= kPayloadBits;
+    }
+    data_.push_back(static_cast<uint8_t>(gap));
+  }
+
+  static constexpr size_t kPayloadBits = 7;
+  static constexpr uint8_t kPayload = 0x7F;
+  static constexpr uint8_t kContinuation = 0x80;
+
+  std::vector<size_t> offsets_;
+  std::vector<uint8_t> data_;
+};
+
+std::vector<size_t> BFS(const CompressedGraph& graph, size_t start,
+                        std::vector<bool>& used) {
   std::queue<size_t> queue;
   std::vector<size_t> res;
   queue.push(start);
@@ -12,7 +146,7 @@ std::vector<size_t> BFS(const std::vector<std::vector<size_t>>& graph,
     size_t cur = queue.front();
     queue.pop();
     res.push_back(cur);
-    for (size_t next : graph[cur]) {
+    for (size_t next : graph.GetNeighbours(cur)) {
       if (used[next]) {
         continue;
       }
@@ -23,26 +157,323 @@ std::vector<size_t> BFS(const std::vector<std::vector<size_t>>& graph,
   return res;
 }
 
-int main() {
-  size_t num_vertices, num_edges;
-  std::cin >> num_vertices >> num_edges;
-  std::vector<std::vector<size_t>> graph(num_vertices + 1);
-  for (size_t i = 0; i < num_edges; ++i) {
-    size_t first, second;
-    std::cin >> first >> second;
-    graph[first].push_back(second);
-    graph[second].push_back(first);
+class DisjointSetUnion {
+ public:
+  DisjointSetUnion(size_t size) : parents_(size), size_(size, 1) {
+    std::iota(parents_.begin(), parents_.end(), 0);
+  }
+
+  size_t FindSet(size_t item) {
+    while (parents_[item] != item) {
+      parents_[item] = parents_[parents_[item]];
+      item = parents_[item];
+    }
+    return item;
+  }
+
+  void Union(size_t first, size_t second) {
+    size_t top_first = FindSet(first);
+    size_t top_second = FindSet(second);
+    if (top_first == top_second) {
+      return;
+    }
+    if (size_[top_first] < size_[top_second]) {
+      std::swap(top_first, top_second);
+    }
+    parents_[top_second] = top_first;
+    size_[top_first] += size_[top_second];
+  }
+
+  size_t Size() const { return parents_.size(); }
+
+ private:
+  std::vector<size_t> parents_;
+  std::vector<size_t> size_;
+};
+
+class EdgeStream {
+ public:
+  EdgeStream(FILE* input) : input_(input), buffer_(kBufferSize) {}
+
+  std::optional<size_t> ReadNumber() {
+    int ch = GetChar();
+    while ((ch != EOF) && ((ch < '0') || (ch > '9'))) {
+      ch = GetChar();
+    }
+    if (ch == EOF) {
+      return std::nullopt;
+    }
+    size_t res = 0;
+    while ((ch >= '0') && (ch <= '9')) {
+      res = res * 10 + (ch - '0');
+      ch = GetChar();
+    }
+    return res;
+  }
+
+ private:
+  int GetChar() {
+    if (pos_ == len_) {
+      pos_ = 0;
+      len_ = fread(buffer_.data(), 1, buffer_.size(), input_);
+      if (len_ == 0) {
+        return EOF;
+      }
+    }
+    return static_cast<unsigned char>(buffer_[pos_++]);
+  }
+
+  static constexpr size_t kBufferSize = 1 << 16;
+
+  FILE* input_;
+  std::vector<char> buffer_;
+  size_t len_ = 0;
+  size_t pos_ = 0;
+};
+
+// Рёбра объединяются по мере чтения, поэтому память -- O(V) при любом
+// количестве рёбер. Компоненты выводятся по возрастанию минимальной вершины.
+void StreamComponents(EdgeStream& stream) {
+  auto num_vertices = stream.ReadNumber();
+  auto num_edges = stream.ReadNumber();
+  if (!num_vertices.has_value() || !num_edges.has_value()) {
+    return;
+  }
+  DisjointSetUnion connect(*num_vertices + 1);
+  for (size_t i = 0; i < *num_edges; ++i) {
+    auto first = stream.ReadNumber();
+    auto second = stream.ReadNumber();
+    if (!second.has_value()) {
+      break;
+    }
+    connect.Union(*first, *second);
+  }
+  constexpr size_t kNoComponent = std::numeric_limits<size_t>::max();
+  std::vector<size_t> component(*num_vertices + 1, kNoComponent);
+  std::vector<size_t> starts;
+  for (size_t vertex = 1; vertex <= *num_vertices; ++vertex) {
+    size_t root = connect.FindSet(vertex);
+    if (component[root] == kNoComponent) {
+      component[root] = starts.size();
+      starts.push_back(0);
+    }
+    ++starts[component[root]];
+  }
+  std::vector<size_t> sizes = starts;
+  size_t total = 0;
+  for (size_t& start : starts) {
+    std::swap(start, total);
+    total += start;
+  }
+  std::vector<size_t> order(*num_vertices);
+  for (size_t vertex = 1; vertex <= *num_vertices; ++vertex) {
+    order[starts[component[connect.FindSet(vertex)]]++] = vertex;
+  }
+  std::cout << sizes.size() << '\n';
+  size_t pos = 0;
+  for (size_t size : sizes) {
+    std::cout << size << '\n';
+    for (size_t i = 0; i < size; ++i) {
+      std::cout << order[pos++] << " ";
+    }
+    std::cout << '\n';
+  }
+}
+
+// Вершинно-ориентированный движок в стиле Pregel. На каждом супершаге
+// Program::Compute вызывается для вершин, которые получили сообщение или не
+// проголосовали за остановку. Сообщения одной вершине сразу сливаются
+// комбинатором в атомарной ячейке следующего буфера, буферы меняются местами
+// между супершагами. Program::kIdentity -- нейтральный элемент комбинатора,
+// он же означает отсутствие сообщения. Вершины -- числа из [0, n).
+template <typename Graph, typename Program>
+class PregelEngine {
+ public:
+  using Value = typename Program::Value;
+  using Message = typename Program::Message;
+
+  class Context {
+   public:
+    const Graph& GetGraph() const { return engine_.graph_; }
+
+    size_t Superstep() const { return engine_.superstep_; }
+
+    void SendMessage(size_t vertex, Message message) {
+      engine_.Send(vertex, message);
+    }
+
+   private:
+    friend class PregelEngine;
+
+    explicit Context(PregelEngine& engine) : engine_(engine) {}
+
+    PregelEngine& engine_;
+  };
+
+  PregelEngine(const Graph& graph, const Program& program,
+               size_t num_threads = 1)
+      : graph_(graph),
+        program_(program),
+        num_threads_(std::max<size_t>(1, num_threads)),
+        values_(graph.VerticesCount()),
+        active_(graph.VerticesCount(), 1),
+        inbox_(graph.VerticesCount()),
+        outbox_(graph.VerticesCount()) {
+    for (size_t vertex = 0; vertex < values_.size(); ++vertex) {
+      values_[vertex] = program_.Initialize(vertex);
+      inbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+      outbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+    }
+  }
+
+  const std::vector<Value>& operator()() {
+    std::barrier sync(num_threads_, [this]() noexcept { FinishSuperstep(); });
+    auto worker = [this, &sync]() {
+      Context context(*this);
+      while (!done_) {
+        for (size_t begin = NextBlock(); begin < values_.size();
+             begin = NextBlock()) {
+          size_t end = std::min(values_.size(), begin + kBlockSize);
+          for (size_t vertex = begin; vertex < end; ++vertex) {
+            ComputeVertex(vertex, context);
+          }
+        }
+        sync.arrive_and_wait();
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_threads_; ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+      thread.join();
+    }
+    return values_;
+  }
+
+  size_t SuperstepsCount() const { return superstep_; }
+
+ private:
+  static constexpr size_t kBlockSize = 1024;
+
+  size_t NextBlock() {
+    return next_block_.fetch_add(kBlockSize, std::memory_order_relaxed);
+  }
+
+  void ComputeVertex(size_t vertex, Context& context) {
+    Message message =
+        inbox_[vertex].exchange(Program::kIdentity, std::memory_order_relaxed);
+    if ((active_[vertex] == 0) && (message == Program::kIdentity)) {
+      return;
+    }
+    active_[vertex] =
+        program_.Compute(vertex, values_[vertex], message, context) ? 1 : 0;
+    if (active_[vertex] != 0) {
+      MarkProgress();
+    }
+  }
+
+  void Send(size_t vertex, Message message) {
+    MarkProgress();
+    std::atomic<Message>& cell = outbox_[vertex];
+    Message current = cell.load(std::memory_order_relaxed);
+    Message combined = Program::Combine(current, message);
+    while ((combined != current) &&
+           !cell.compare_exchange_weak(current, combined,
+                                       std::memory_order_relaxed)) {
+      combined = Program::Combine(current, message);
+    }
+  }
+
+  void MarkProgress() {
+    if (!progress_.load(std::memory_order_relaxed)) {
+      progress_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Выполняется одним потоком, когда все дошли до барьера.
+  void FinishSuperstep() {
+    std::swap(inbox_, outbox_);
+    ++superstep_;
+    next_block_.store(0, std::memory_order_relaxed);
+    done_ = !progress_.exchange(false, std::memory_order_relaxed);
   }
-  std::vector<bool> used(num_vertices + 1, false);
+
+  const Graph& graph_;
+  Program program_;
+  size_t num_threads_;
+  std::vector<Value> values_;
+  std::vector<uint8_t> active_;
+  std::vector<std::atomic<Message>> inbox_;
+  std::vector<std::atomic<Message>> outbox_;
+  std::atomic<size_t> next_block_ = 0;
+  std::atomic<bool> progress_ = false;
+  size_t superstep_ = 0;
+  bool done_ = false;
+};
+
+// Компоненты связности распространением наименьшей метки: в итоге метка
+// вершины -- минимальная вершина её компоненты.
+struct ComponentsProgram {
+  using Value = size_t;
+  using Message = size_t;
+
+  static constexpr Message kIdentity = std::numeric_limits<Message>::max();
+
+  static Message Combine(Message first, Message second) {
+    return std::min(first, second);
+  }
+
+  Value Initialize(size_t vertex) const { return vertex; }
+
+  template <typename Context>
+  bool Compute(size_t vertex, Value& label, Message message,
+               Context& context) const {
+    if ((context.Superstep() > 0) && (message >= label)) {
+      return false;
+    }
+    label = std::min(label, message);
+    for (size_t next : context.GetGraph().GetNeighbours(vertex)) {
+      context.SendMessage(next, label);
+    }
+    return false;
+  }
+};
+
+std::vector<std::vector<size_t>> FindComponents(const CompressedGraph& graph) {
+  std::vector<bool> used(graph.VerticesCount(), false);
   std::vector<std::vector<size_t>> res;
-  for (size_t vertex = 1; vertex <= num_vertices; ++vertex) {
+  for (size_t vertex = 1; vertex < graph.VerticesCount(); ++vertex) {
     if (used[vertex]) {
       continue;
     }
     res.push_back(BFS(graph, vertex, used));
   }
-  std::cout << res.size() << std::endl;
-  for (auto list : res) {
+  return res;
+}
+
+std::vector<std::vector<size_t>> FindComponents(const CompressedGraph& graph,
+                                                size_t num_threads) {
+  PregelEngine<CompressedGraph, ComponentsProgram> engine(
+      graph, ComponentsProgram(), num_threads);
+  const std::vector<size_t>& labels = engine();
+  constexpr size_t kNoComponent = std::numeric_limits<size_t>::max();
+  std::vector<size_t> component(labels.size(), kNoComponent);
+  std::vector<std::vector<size_t>> res;
+  for (size_t vertex = 1; vertex < labels.size(); ++vertex) {
+    if (component[labels[vertex]] == kNoComponent) {
+      component[labels[vertex]] = res.size();
+      res.emplace_back();
+    }
+    res[component[labels[vertex]]].push_back(vertex);
+  }
+  return res;
+}
+
+void PrintComponents(const std::vector<std::vector<size_t>>& components) {
+  std::cout << components.size() << std::endl;
+  for (const auto& list : components) {
     std::cout << list.size() << std::endl;
     for (auto item : list) {
       std::cout << item << " ";
@@ -50,3 +481,57 @@ int main() {
     std::cout << std::endl;
   }
 }
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
+  if (mode == "--stream") {
+    FILE* input = (argc > 2) ? fopen(argv[2], "rb") : stdin;
+    if (input == nullptr) {
+      std::cerr << "cannot open " << argv[2] << std::endl;
+      return 1;
+    }
+    EdgeStream stream(input);
+    StreamComponents(stream);
+    if (input != stdin) {
+      fclose(input);
+    }
+    return 0;
+  }
+  size_t num_vertices, num_edges;
+  std::cin >> num_vertices >> num_edges;
+  std::vector<std::pair<size_t, size_t>> edges(num_edges);
+  for (size_t i = 0; i < num_edges; ++i) {
+    std::cin >> edges[i].first >> edges[i].second;
+  }
+  CompressedGraph graph(num_vertices + 1, edges);
+  edges.clear();
+  edges.shrink_to_fit();
+  size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                  : std::thread::hardware_concurrency();
+  if (mode == "--pregel") {
+    PrintComponents(FindComponents(graph, num_threads));
+    return 0;
+  }
+  if (mode == "--bench") {
+    auto start = std::chrono::steady_clock::now();
+    auto sequential = FindComponents(graph);
+    auto middle = std::chrono::steady_clock::now();
+    auto parallel = FindComponents(graph, num_threads);
+    auto finish = std::chrono::steady_clock::now();
+    for (auto& list : sequential) {
+      std::sort(list.begin(), list.end());
+    }
+    std::sort(sequential.begin(), sequential.end());
+    std::cerr << "sequential: "
+              << std::chrono::duration<double, std::milli>(middle - start)
+                     .count()
+              << " ms, pregel (" << num_threads << " threads): "
+              << std::chrono::duration<double, std::milli>(finish - middle)
+                     .count()
+              << " ms" << (sequential == parallel ? "" : ", MISMATCH")
+              << std::endl;
+    PrintComponents(parallel);
+    return 0;
+  }
+  PrintComponents(FindComponents(graph));
+}
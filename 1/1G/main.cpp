@@ -1,10 +1,17 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
 #include <optional>
 #include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -318,6 +325,153 @@ class ListGraph : public Graph<Vertex, Edge, std::list<Edge>> {
   std::unordered_map<Vertex, std::list<Edge>> adjacent_;
 };
 
+// Ядерная декомпозиция за O(n + m) (Batagelj--Zaversnik): вершины снимаются
+// в порядке неубывания текущей степени, степени и позиции хранятся в плоских
+// массивах, упорядоченных корзинами по степени.
+template <typename Graph>
+class CoreDecomposition {
+ public:
+  using VertexType = typename Graph::VertexType;
+
+  explicit CoreDecomposition(const Graph& graph) {
+    for (auto vertex : graph.GetVertices()) {
+      index_[vertex] = vertices_.size();
+      vertices_.push_back(vertex);
+    }
+    std::vector<size_t> offsets(vertices_.size() + 1, 0);
+    std::vector<size_t> neighbours;
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+      for (auto adj : graph.GetNeighbours(vertices_[i])) {
+        neighbours.push_back(index_.at(adj));
+      }
+      offsets[i + 1] = neighbours.size();
+    }
+    std::vector<size_t> degree(vertices_.size());
+    size_t max_degree = 0;
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+      degree[i] = offsets[i + 1] - offsets[i];
+      max_degree = std::max(max_degree, degree[i]);
+    }
+    std::vector<size_t> bins(max_degree + 1, 0);
+    for (size_t value : degree) {
+      ++bins[value];
+    }
+    size_t start = 0;
+    for (size_t& bin : bins) {
+      std::swap(bin, start);
+      start += bin;
+    }
+    std::vector<size_t> order(vertices_.size());
+    std::vector<size_t> position(vertices_.size());
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+      position[i] = bins[degree[i]]++;
+      order[position[i]] = i;
+    }
+    for (size_t value = max_degree; value > 0; --value) {
+      bins[value] = bins[value - 1];
+    }
+    bins[0] = 0;
+    for (size_t cur : order) {
+      for (size_t i = offsets[cur]; i < offsets[cur + 1]; ++i) {
+        size_t adj = neighbours[i];
+        if (degree[adj] <= degree[cur]) {
+          continue;
+        }
+        size_t first = order[bins[degree[adj]]];
+        if (first != adj) {
+          std::swap(order[position[adj]], order[position[first]]);
+          std::swap(position[adj], position[first]);
+        }
+        ++bins[degree[adj]];
+        --degree[adj];
+      }
+    }
+    cores_ = std::move(degree);
+  }
+
+  size_t GetCore(const VertexType& vertex) const {
+    return cores_[index_.at(vertex)];
+  }
+
+  size_t MaxCore() const {
+    return cores_.empty() ? 0 : *std::max_element(cores_.begin(), cores_.end());
+  }
+
+ private:
+  std::vector<VertexType> vertices_;
+  std::unordered_map<VertexType, size_t> index_;
+  std::vector<size_t> cores_;
+};
+
+// Подграф k-ядра поверх исходного графа: обходы видят только вершины с
+// ядерным числом не меньше k и рёбра между ними.
+template <typename Graph>
+class CoreView {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using EdgeType = typename Graph::EdgeType;
+
+  CoreView(const Graph& graph, const CoreDecomposition<Graph>& cores,
+           size_t min_core)
+      : graph_(graph), cores_(cores), min_core_(min_core) {}
+
+  bool Contains(const VertexType& vertex) const {
+    return cores_.GetCore(vertex) >= min_core_;
+  }
+
+  size_t VerticesCount() const { return GetVertices().size(); }
+
+  size_t EdgesCount() const {
+    size_t res = 0;
+    for (auto vertex : GetVertices()) {
+      res += GetNeighbours(vertex).size();
+    }
+    return res / 2;
+  }
+
+  std::list<VertexType> GetNeighbours(const VertexType& vertex) const {
+    std::list<VertexType> res = graph_.GetNeighbours(vertex);
+    res.remove_if([this](const VertexType& adj) { return !Contains(adj); });
+    return res;
+  }
+
+  std::list<VertexType> GetVertices() const {
+    std::list<VertexType> res = graph_.GetVertices();
+    res.remove_if(
+        [this](const VertexType& vertex) { return !Contains(vertex); });
+    return res;
+  }
+
+  auto IterateNeighbours(const VertexType& vertex,
+                         std::function<bool(EdgeType)> filter) const {
+    return graph_.IterateNeighbours(vertex, [this, filter](EdgeType edge) {
+      return Contains(edge.second) && filter(edge);
+    });
+  }
+
+  auto IterateNeighbours(const VertexType& vertex) const {
+    return IterateNeighbours(vertex, [](EdgeType /*unused*/) { return true; });
+  }
+
+  bool HasEdge(const VertexType& first, const VertexType& second) const {
+    return Contains(first) && Contains(second) &&
+           graph_.HasEdge(first, second);
+  }
+
+  std::optional<EdgeType> GetEdge(const VertexType& first,
+                                  const VertexType& second) const {
+    if (!Contains(first) || !Contains(second)) {
+      return std::nullopt;
+    }
+    return graph_.GetEdge(first, second);
+  }
+
+ private:
+  const Graph& graph_;
+  const CoreDecomposition<Graph>& cores_;
+  size_t min_core_;
+};
+
 template <typename Graph>
 class Visitor {
  public:
@@ -472,6 +626,118 @@ class DFS {
   std::unordered_map<typename Graph::VertexType, VertexColor> colors_;
 };
 
+// Канонизация рёбер при загрузке: рёбра поразрядно сортируются по
+// упакованному ключу (u, v) в несколько потоков, рёбра с одинаковым ключом
+// сливаются функцией merge, петли по желанию отбрасываются.
+template <typename Key, typename Merge>
+class EdgeCanonicalizer {
+ public:
+  EdgeCanonicalizer(Key key, Merge merge, bool drop_loops = true,
+                    size_t num_threads = std::thread::hardware_concurrency())
+      : key_(key),
+        merge_(merge),
+        drop_loops_(drop_loops),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  template <typename Edge>
+  std::vector<Edge> operator()(std::vector<Edge> edges) const {
+    std::vector<uint64_t> keys(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      keys[i] = Pack(key_(edges[i]));
+    }
+    Sort(edges, keys);
+    std::vector<Edge> res;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (drop_loops_ && ((keys[i] >> kHalfBits) == (keys[i] & kHalfMask))) {
+        continue;
+      }
+      if (!res.empty() && (keys[i] == keys[i - 1])) {
+        merge_(res.back(), edges[i]);
+      } else {
+        res.push_back(edges[i]);
+      }
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kHalfBits = 32;
+  static constexpr uint64_t kHalfMask = (uint64_t{1} << kHalfBits) - 1;
+  static constexpr size_t kDigitBits = 8;
+  static constexpr size_t kBuckets = size_t{1} << kDigitBits;
+  static constexpr size_t kMinChunk = size_t{1} << 16;
+
+  template <typename Pair>
+  static uint64_t Pack(const Pair& pair) {
+    auto first = static_cast<uint64_t>(pair.first);
+    auto second = static_cast<uint64_t>(pair.second);
+    if ((first > kHalfMask) || (second > kHalfMask)) {
+      throw std::overflow_error("vertex does not fit into the edge key");
+    }
+    return (first << kHalfBits) | second;
+  }
+
+  // Устойчивая LSD-сортировка по байтам ключа: каждый поток считает
+  // гистограмму своего куска, а затем раскладывает его по своим смещениям.
+  template <typename Edge>
+  void Sort(std::vector<Edge>& edges, std::vector<uint64_t>& keys) const {
+    size_t num_threads =
+        std::min(num_threads_, std::max<size_t>(1, edges.size() / kMinChunk));
+    size_t chunk = (edges.size() + num_threads - 1) / num_threads;
+    uint64_t max_key = 0;
+    for (uint64_t key : keys) {
+      max_key = std::max(max_key, key);
+    }
+    std::vector<Edge> edges_buffer(edges.size());
+    std::vector<uint64_t> keys_buffer(keys.size());
+    std::vector<std::array<size_t, kBuckets>> offsets(num_threads);
+    for (size_t shift = 0; (shift < 64) && ((max_key >> shift) != 0);
+         shift += kDigitBits) {
+      ForEachChunk(num_threads, [&](size_t thread) {
+        offsets[thread].fill(0);
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          ++offsets[thread][(keys[i] >> shift) & (kBuckets - 1)];
+        }
+      });
+      size_t total = 0;
+      for (size_t digit = 0; digit < kBuckets; ++digit) {
+        for (auto& counts : offsets) {
+          std::swap(counts[digit], total);
+          total += counts[digit];
+        }
+      }
+      ForEachChunk(num_threads, [&](size_t thread) {
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          size_t pos = offsets[thread][(keys[i] >> shift) & (kBuckets - 1)]++;
+          edges_buffer[pos] = edges[i];
+          keys_buffer[pos] = keys[i];
+        }
+      });
+      std::swap(edges, edges_buffer);
+      std::swap(keys, keys_buffer);
+    }
+  }
+
+  template <typename Body>
+  static void ForEachChunk(size_t num_threads, Body body) {
+    std::vector<std::thread> workers;
+    for (size_t thread = 1; thread < num_threads; ++thread) {
+      workers.emplace_back(body, thread);
+    }
+    body(0);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  Key key_;
+  Merge merge_;
+  bool drop_loops_;
+  size_t num_threads_;
+};
+
 template <typename Vertex = size_t>
 struct Edge {
   uint32_t number;
@@ -484,7 +750,8 @@ struct Edge {
   bool operator<(const Edge& other) const { return number < other.number; }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   size_t num_vertices, num_edges;
   std::cin >> num_vertices >> num_edges;
   std::vector<uint16_t> vertices(num_vertices);
@@ -496,7 +763,22 @@ int main() {
     edges[i].number = i + 1;
     std::cin >> edges[i].first >> edges[i].second;
   }
+  EdgeCanonicalizer canonicalize(
+      [](const Edge<uint16_t>& edge) {
+        return std::minmax(edge.first, edge.second);
+      },
+      [](Edge<uint16_t>& edge, const Edge<uint16_t>& repeat) {
+        edge.repeat += repeat.repeat;
+      });
+  edges = canonicalize(std::move(edges));
   MatrixGraph<uint16_t, Edge<uint16_t>> graph(vertices, edges);
+  if (mode == "--cores") {
+    CoreDecomposition<decltype(graph)> cores(graph);
+    for (uint16_t vertex : vertices) {
+      std::cout << cores.GetCore(vertex) << std::endl;
+    }
+    return 0;
+  }
   DFS<decltype(graph), BridgesFinder<decltype(graph)>> finder(graph);
   finder();
   const std::vector<Edge<uint16_t>>& res = finder.GetVisitor().GetBridges();
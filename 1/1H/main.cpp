@@ -1,29 +1,146 @@
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 #include <vector>
 
+// Канонизация рёбер при загрузке: рёбра поразрядно сортируются по
+// упакованному ключу (u, v) в несколько потоков, рёбра с одинаковым ключом
+// сливаются функцией merge, петли по желанию отбрасываются.
+template <typename Key, typename Merge>
+class EdgeCanonicalizer {
+ public:
+  EdgeCanonicalizer(Key key, Merge merge, bool drop_loops = true,
+                    size_t num_threads = std::thread::hardware_concurrency())
+      : key_(key),
+        merge_(merge),
+        drop_loops_(drop_loops),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  template <typename Edge>
+  std::vector<Edge> operator()(std::vector<Edge> edges) const {
+    std::vector<uint64_t> keys(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      keys[i] = Pack(key_(edges[i]));
+    }
+    Sort(edges, keys);
+    std::vector<Edge> res;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (drop_loops_ && ((keys[i] >> kHalfBits) == (keys[i] & kHalfMask))) {
+        continue;
+      }
+      if (!res.empty() && (keys[i] == keys[i - 1])) {
+        merge_(res.back(), edges[i]);
+      } else {
+        res.push_back(edges[i]);
+      }
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kHalfBits = 32;
+  static constexpr uint64_t kHalfMask = (uint64_t{1} << kHalfBits) - 1;
+  static constexpr size_t kDigitBits = 8;
+  static constexpr size_t kBuckets = size_t{1} << kDigitBits;
+  static constexpr size_t kMinChunk = size_t{1} << 16;
+
+  template <typename Pair>
+  static uint64_t Pack(const Pair& pair) {
+    auto first = static_cast<uint64_t>(pair.first);
+    auto second = static_cast<uint64_t>(pair.second);
+    if ((first > kHalfMask) || (second > kHalfMask)) {
+      throw std::overflow_error("vertex does not fit into the edge key");
+    }
+    return (first << kHalfBits) | second;
+  }
+
+  // Устойчивая LSD-сортировка по байтам ключа: каждый поток считает
+  // гистограмму своего куска, а затем раскладывает его по своим смещениям.
+  template <typename Edge>
+  void Sort(std::vector<Edge>& edges, std::vector<uint64_t>& keys) const {
+    size_t num_threads =
+        std::min(num_threads_, std::max<size_t>(1, edges.size() / kMinChunk));
+    size_t chunk = (edges.size() + num_threads - 1) / num_threads;
+    uint64_t max_key = 0;
+    for (uint64_t key : keys) {
+      max_key = std::max(max_key, key);
+    }
+    std::vector<Edge> edges_buffer(edges.size());
+    std::vector<uint64_t> keys_buffer(keys.size());
+    std::vector<std::array<size_t, kBuckets>> offsets(num_threads);
+    for (size_t shift = 0; (shift < 64) && ((max_key >> shift) != 0);
+         shift += kDigitBits) {
+      ForEachChunk(num_threads, [&](size_t thread) {
+        offsets[thread].fill(0);
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          ++offsets[thread][(keys[i] >> shift) & (kBuckets - 1)];
+        }
+      });
+      size_t total = 0;
+      for (size_t digit = 0; digit < kBuckets; ++digit) {
+        for (auto& counts : offsets) {
+          std::swap(counts[digit], total);
+          total += counts[digit];
+        }
+      }
+      ForEachChunk(num_threads, [&](size_t thread) {
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          size_t pos = offsets[thread][(keys[i] >> shift) & (kBuckets - 1)]++;
+          edges_buffer[pos] = edges[i];
+          keys_buffer[pos] = keys[i];
+        }
+      });
+      std::swap(edges, edges_buffer);
+      std::swap(keys, keys_buffer);
+    }
+  }
+
+  template <typename Body>
+  static void ForEachChunk(size_t num_threads, Body body) {
+    std::vector<std::thread> workers;
+    for (size_t thread = 1; thread < num_threads; ++thread) {
+      workers.emplace_back(body, thread);
+    }
+    body(0);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  Key key_;
+  Merge merge_;
+  bool drop_loops_;
+  size_t num_threads_;
+};
+
 using Edge = std::pair<size_t, size_t>;
 
 class Graph {
  public:
   Graph(size_t num_vertices, const std::vector<Edge>& edges)
-      : matrix_(num_vertices + 1, std::set<size_t>()) {
+      : matrix_(num_vertices + 1) {
     for (auto edge : edges) {
-      matrix_[edge.first].insert(edge.second);
-      matrix_[edge.second].insert(edge.first);
+      matrix_[edge.first].push_back(edge.second);
+      matrix_[edge.second].push_back(edge.first);
     }
   }
 
   size_t NumVertices() const { return matrix_.size() - 1; }
 
-  const std::set<size_t>& GetNeighbours(size_t vertex) const {
+  const std::vector<size_t>& GetNeighbours(size_t vertex) const {
     return matrix_[vertex];
   }
 
  private:
-  std::vector<std::set<size_t>> matrix_;
+  std::vector<std::vector<size_t>> matrix_;
 };
 
 class DFS {
@@ -85,7 +202,10 @@ int main() {
   for (size_t i = 0; i < num_edges; ++i) {
     std::cin >> edges[i].first >> edges[i].second;
   }
-  Graph graph(num_vertices, edges);
+  EdgeCanonicalizer canonicalize(
+      [](const Edge& edge) { return std::minmax(edge.first, edge.second); },
+      [](Edge& /*unused*/, const Edge& /*unused*/) {});
+  Graph graph(num_vertices, canonicalize(std::move(edges)));
   DFS dfs(graph);
   auto res = dfs();
   std::cout << res.size() << std::endl;
@@ -1,7 +1,6 @@
-#include <functional>
+#include <algorithm>
 #include <iostream>
 #include <limits>
-#include <unordered_set>
 #include <vector>
 
 using Vertex = size_t;
@@ -18,127 +17,83 @@ struct Edge {
   Edge Reverse() const { return Edge{second, first, number}; }
 };
 
-template <>
-struct std::hash<Edge> {
-  size_t operator()(const Edge& edge) const {
-    return std::hash<size_t>{}(edge.number);
-  }
-};
-
 using Graph = std::vector<std::vector<Edge>>;
 
-class FindBridges {
+// Один обход: мосты отмечаются в битовом массиве по номеру ребра, компоненты
+// рёберной двусвязности снимаются со стека в момент нахождения моста, а
+// степени в дереве мостов считаются сразу же.
+class CountRequiredEdges {
  public:
-  FindBridges(const Graph& graph)
+  CountRequiredEdges(const Graph& graph, size_t num_edges)
       : graph_(graph),
-        used_(graph.size(), false),
-        t_in_(graph.size(), std::numeric_limits<size_t>::max()),
-        f_up_(graph.size(), std::numeric_limits<size_t>::max()) {}
+        is_bridge_(num_edges, false),
+        t_in_(graph.size(), kUnvisited),
+        f_up_(graph.size(), kUnvisited),
+        component_(graph.size(), kNoComponent) {}
 
-  std::unordered_set<Edge> operator()(Vertex start) {
-    used_[start] = true;
-    t_in_[start] = f_up_[start] = time_++;
-    std::unordered_set<Edge> res;
-    for (auto edge : graph_[start]) {
-      Visit(edge.second, edge, res);
-      f_up_[start] = std::min(f_up_[start], f_up_[edge.second]);
-      if (f_up_[edge.second] > t_in_[start]) {
-        res.insert(edge);
+  size_t operator()() {
+    for (Vertex start = 1; start < graph_.size(); ++start) {
+      if (t_in_[start] == kUnvisited) {
+        Visit(start, Edge{start, start, kNoEdge});
+        PopComponent(start);
       }
     }
-    for (auto bridge : res) {
-      std::cout << bridge.first << "-" << bridge.second << std::endl;
+    for (Vertex head : bridge_heads_) {
+      ++degree_[component_[head]];
     }
-    return res;
+    size_t res = std::count(degree_.begin(), degree_.end(), 1);
+    return (res == 0) ? 0 : ((res - 1) / 2 + 1);
   }
 
+  bool IsBridge(size_t number) const { return is_bridge_[number]; }
+
  private:
-  void Visit(Vertex vertex, Edge edge, std::unordered_set<Edge>& res) {
-    used_[vertex] = true;
+  void Visit(Vertex vertex, Edge parent) {
     t_in_[vertex] = f_up_[vertex] = time_++;
+    stack_.push_back(vertex);
     for (auto next : graph_[vertex]) {
-      if (next == edge) {
+      if (next == parent) {
         continue;
       }
-      if (used_[next.second]) {
+      if (t_in_[next.second] != kUnvisited) {
         f_up_[vertex] = std::min(f_up_[vertex], t_in_[next.second]);
-      } else {
-        Visit(next.second, next, res);
-        f_up_[vertex] = std::min(f_up_[vertex], f_up_[next.second]);
-        if (f_up_[next.second] > t_in_[vertex]) {
-          res.insert(next);
-        }
-      }
-    }
-  }
-
-  const Graph& graph_;
-  std::vector<bool> used_;
-  std::vector<size_t> t_in_;
-  std::vector<size_t> f_up_;
-  size_t time_ = 0;
-};
-
-class CountRequiredEdges {
- public:
-  CountRequiredEdges(const Graph& graph)
-      : graph_(graph), used_(graph.size(), false) {
-    bridges_ = FindBridges{graph}(1);
-  }
-
-  size_t operator()() {
-    size_t res = 0;
-    for (size_t start = 1; start < graph_.size(); ++start) {
-      if (!used_[start]) {
-        used_[start] = true;
-        size_t num_bridges = Visit(start);
-        if (num_bridges == 1) {
-          ++res;
-        }
-      }
-    }
-    return (res == 0) ? 0 : ((res - 1) / 2 + 1);
-  }
-
- private:
-  size_t Visit(Vertex vertex) {
-    size_t num_bridges = 0;
-    used_[vertex] = true;
-    for (auto next : graph_[vertex]) {
-      if (bridges_.count(next) != 0) {
-        ++num_bridges;
         continue;
       }
-      if (used_[next.second]) {
-        continue;
+      Visit(next.second, next);
+      f_up_[vertex] = std::min(f_up_[vertex], f_up_[next.second]);
+      if (f_up_[next.second] > t_in_[vertex]) {
+        is_bridge_[next.number] = true;
+        PopComponent(next.second);
+        ++degree_[component_[next.second]];
+        bridge_heads_.push_back(vertex);
       }
-      num_bridges += Visit(next.second, next);
     }
-    return num_bridges;
   }
 
-  size_t Visit(Vertex vertex, Edge parent) {
-    size_t num_bridges = 0;
-    used_[vertex] = true;
-    for (auto next : graph_[vertex]) {
-      if (next == parent) {
-        continue;
-      }
-      if (bridges_.count(next) != 0) {
-        ++num_bridges;
-        continue;
-      }
-      if (used_[next.second]) {
-        continue;
-      }
-      num_bridges += Visit(next.second, next);
-    }
-    return num_bridges;
+  void PopComponent(Vertex root) {
+    size_t id = degree_.size();
+    degree_.push_back(0);
+    Vertex cur;
+    do {
+      cur = stack_.back();
+      stack_.pop_back();
+      component_[cur] = id;
+    } while (cur != root);
   }
 
+  static constexpr size_t kUnvisited = std::numeric_limits<size_t>::max();
+  static constexpr size_t kNoComponent = std::numeric_limits<size_t>::max();
+  static constexpr size_t kNoEdge = std::numeric_limits<size_t>::max();
+
   const Graph& graph_;
-  std::vector<bool> used_;
-  std::unordered_set<Edge> bridges_;
+  std::vector<bool> is_bridge_;
+  std::vector<size_t> t_in_;
+  std::vector<size_t> f_up_;
+  std::vector<size_t> component_;
+  std::vector<size_t> degree_;
+  std::vector<Vertex> stack_;
+  std::vector<Vertex> bridge_heads_;
+  size_t time_ = 0;
 };
 
 int main() {
@@ -152,5 +107,5 @@ int main() {
     map[edge.first].push_back(edge);
     map[edge.second].push_back(edge.Reverse());
   }
-  std::cout << CountRequiredEdges{map}() << std::endl;
+  std::cout << CountRequiredEdges{map, num_routes}() << std::endl;
 }
\ No newline at end of file
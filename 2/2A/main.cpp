@@ -1,14 +1,31 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <numeric>
 #include <optional>
-#include <queue>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -228,6 +245,167 @@ struct WeightedEdge {
   using WeightType = Weight;
 };
 
+// Четверичная куча над индексами из [0, n) с уменьшением ключа. Позиции
+// индексов хранятся в плоском массиве, так что каждый индекс лежит в куче не
+// больше одного раза.
+template <typename Key>
+class IndexedHeap {
+ public:
+  explicit IndexedHeap(size_t num_indices = 0)
+      : positions_(num_indices, kAbsent) {}
+
+  bool Empty() const { return items_.empty(); }
+
+  size_t Size() const { return items_.size(); }
+
+  bool Contains(size_t index) const {
+    return (index < positions_.size()) && (positions_[index] != kAbsent);
+  }
+
+  // Добавляет индекс либо уменьшает его ключ; больший ключ игнорируется.
+  void Push(size_t index, Key key) {
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    size_t pos = positions_[index];
+    if (pos == kAbsent) {
+      pos = items_.size();
+      items_.push_back({key, index});
+    } else if (key < items_[pos].first) {
+      items_[pos].first = key;
+    } else {
+      return;
+    }
+    SiftUp(pos);
+  }
+
+  std::pair<Key, size_t> Pop() {
+    std::pair<Key, size_t> res = items_.front();
+    positions_[res.second] = kAbsent;
+    items_.front() = items_.back();
+    items_.pop_back();
+    if (!items_.empty()) {
+      positions_[items_.front().second] = 0;
+      SiftDown(0);
+    }
+    return res;
+  }
+
+  void Clear() {
+    for (const auto& item : items_) {
+      positions_[item.second] = kAbsent;
+    }
+    items_.clear();
+  }
+
+ private:
+  static constexpr size_t kArity = 4;
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  void SiftUp(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / kArity;
+      if (!(item.first < items_[parent].first)) {
+        break;
+      }
+      Place(pos, items_[parent]);
+      pos = parent;
+    }
+    Place(pos, item);
+  }
+
+  void SiftDown(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (true) {
+      size_t first_child = pos * kArity + 1;
+      if (first_child >= items_.size()) {
+        break;
+      }
+      size_t last_child = std::min(first_child + kArity, items_.size());
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (items_[child].first < items_[best].first) {
+          best = child;
+        }
+      }
+      if (!(items_[best].first < item.first)) {
+        break;
+      }
+      Place(pos, items_[best]);
+      pos = best;
+    }
+    Place(pos, item);
+  }
+
+  void Place(size_t pos, const std::pair<Key, size_t>& item) {
+    items_[pos] = item;
+    positions_[item.second] = pos;
+  }
+
+  std::vector<std::pair<Key, size_t>> items_;
+  std::vector<size_t> positions_;
+};
+
+// Состояние поиска кратчайших путей, переиспользуемое между запросами.
+// Вместо очистки массивов увеличивается номер эпохи: значения с устаревшей
+// отметкой считаются сброшенными, так что запрос стоит столько, сколько
+// вершин он затронул.
+template <typename Weight, typename Queue = IndexedHeap<Weight>>
+class SsspWorkspace {
+ public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+  explicit SsspWorkspace(size_t num_vertices = 0) { Reset(num_vertices); }
+
+  void Reset(size_t num_vertices) {
+    if (num_vertices > dist_.size()) {
+      dist_.resize(num_vertices);
+      parents_.resize(num_vertices);
+      dist_stamps_.resize(num_vertices, 0);
+      visited_stamps_.resize(num_vertices, 0);
+    }
+    queue_.Clear();
+    if (++epoch_ == 0) {
+      std::fill(dist_stamps_.begin(), dist_stamps_.end(), 0);
+      std::fill(visited_stamps_.begin(), visited_stamps_.end(), 0);
+      epoch_ = 1;
+    }
+  }
+
+  Weight GetDistance(size_t vertex) const {
+    return (dist_stamps_[vertex] == epoch_) ? dist_[vertex] : kInfinity;
+  }
+
+  size_t GetParent(size_t vertex) const {
+    return (dist_stamps_[vertex] == epoch_) ? parents_[vertex] : kNoParent;
+  }
+
+  void SetDistance(size_t vertex, Weight dist, size_t parent = kNoParent) {
+    dist_[vertex] = dist;
+    parents_[vertex] = parent;
+    dist_stamps_[vertex] = epoch_;
+  }
+
+  bool IsVisited(size_t vertex) const {
+    return visited_stamps_[vertex] == epoch_;
+  }
+
+  void MarkVisited(size_t vertex) { visited_stamps_[vertex] = epoch_; }
+
+  Queue& GetQueue() { return queue_; }
+
+ private:
+  std::vector<Weight> dist_;
+  std::vector<size_t> parents_;
+  std::vector<uint32_t> dist_stamps_;
+  std::vector<uint32_t> visited_stamps_;
+  uint32_t epoch_ = 0;
+  Queue queue_;
+};
+
+// Вершины -- числа из [0, n), где n = graph.VerticesCount().
 template <typename Graph, typename Visitor>
 class DijkstraSearch {
  public:
@@ -235,35 +413,49 @@ class DijkstraSearch {
   using EdgeType = typename Graph::EdgeType;
   using WeightType = typename EdgeType::WeightType;
 
-  std::unordered_map<VertexType, WeightType> operator()(
-      const Graph& graph, const VertexType& start) {
-    std::unordered_map<VertexType, WeightType> dist;
-    dist[start] = 0;
-    std::unordered_set<VertexType> used;
-    std::priority_queue<std::pair<WeightType, VertexType>,
-                        std::vector<std::pair<WeightType, VertexType>>,
-                        std::greater<std::pair<WeightType, VertexType>>>
-        queue;
-    queue.push({0, start});
+  static constexpr WeightType kInfinity =
+      SsspWorkspace<WeightType>::kInfinity;
+
+  // Результат остаётся в workspace. Если задан finish, поиск
+  // останавливается, как только расстояние до него окончательно.
+  void operator()(const Graph& graph, const VertexType& start,
+                  SsspWorkspace<WeightType>& workspace,
+                  std::optional<VertexType> finish = std::nullopt) {
+    workspace.Reset(graph.VerticesCount());
+    auto& queue = workspace.GetQueue();
+    workspace.SetDistance(start, 0);
+    queue.Push(start, 0);
     visitor_.Start(graph, start);
-    while (!queue.empty()) {
-      VertexType cur = queue.top().second;
-      queue.pop();
-      if (used.count(cur) != 0) {
-        continue;
-      }
-      used.insert(cur);
+    while (!queue.Empty()) {
+      auto [cur_dist, cur] = queue.Pop();
+      workspace.MarkVisited(cur);
       visitor_.ExamineVertex(graph, cur);
+      if (finish == cur) {
+        return;
+      }
       for (auto edge : graph.GetEdges(cur)) {
         visitor_.ExamineEdge(graph, edge);
-        if ((dist.count(edge.second) == 0) ||
-            (dist[edge.second] > dist[edge.first] + edge.weight)) {
-          dist[edge.second] = dist[edge.first] + edge.weight;
-          queue.push({dist[edge.second], edge.second});
+        if (workspace.IsVisited(edge.second)) {
+          continue;
+        }
+        WeightType candidate = cur_dist + edge.weight;
+        if (candidate < workspace.GetDistance(edge.second)) {
+          workspace.SetDistance(edge.second, candidate, cur);
+          queue.Push(edge.second, candidate);
           visitor_.Optimize(graph, edge);
         }
       }
     }
+  }
+
+  std::vector<WeightType> operator()(const Graph& graph,
+                                     const VertexType& start) {
+    SsspWorkspace<WeightType> workspace;
+    (*this)(graph, start, workspace);
+    std::vector<WeightType> dist(graph.VerticesCount());
+    for (size_t vertex = 0; vertex < dist.size(); ++vertex) {
+      dist[vertex] = workspace.GetDistance(vertex);
+    }
     return dist;
   }
 
@@ -273,11 +465,674 @@ class DijkstraSearch {
   Visitor visitor_;
 };
 
-int main() {
+template <typename Vertex, typename Weight>
+class Heuristic {
+ public:
+  virtual Weight operator()(const Vertex&) const = 0;
+};
+
+// A* поверх SsspWorkspace: ключ в очереди -- расстояние плюс оценка
+// heuristic до finish. Оценка должна быть монотонной, тогда извлечённая
+// вершина окончательна, как в DijkstraSearch.
+template <typename Graph, typename Visitor>
+class AStarSearch {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using EdgeType = typename Graph::EdgeType;
+  using WeightType = typename EdgeType::WeightType;
+
+  static constexpr WeightType kInfinity =
+      SsspWorkspace<WeightType>::kInfinity;
+
+  AStarSearch(const Heuristic<VertexType, WeightType>& heuristic)
+      : heuristic_(heuristic) {}
+
+  WeightType operator()(const Graph& graph, const VertexType& start,
+                        const VertexType& finish,
+                        SsspWorkspace<WeightType>& workspace) {
+    workspace.Reset(graph.VerticesCount());
+    auto& queue = workspace.GetQueue();
+    workspace.SetDistance(start, 0);
+    queue.Push(start, heuristic_(start));
+    visitor_.Start(graph, start);
+    while (!queue.Empty()) {
+      VertexType cur = queue.Pop().second;
+      workspace.MarkVisited(cur);
+      ++settled_;
+      visitor_.ExamineVertex(graph, cur);
+      if (cur == finish) {
+        break;
+      }
+      WeightType cur_dist = workspace.GetDistance(cur);
+      for (auto edge : graph.GetEdges(cur)) {
+        visitor_.ExamineEdge(graph, edge);
+        if (workspace.IsVisited(edge.second)) {
+          continue;
+        }
+        WeightType candidate = cur_dist + edge.weight;
+        if (candidate < workspace.GetDistance(edge.second)) {
+          workspace.SetDistance(edge.second, candidate, cur);
+          queue.Push(edge.second, candidate + heuristic_(edge.second));
+          visitor_.Optimize(graph, edge);
+        }
+      }
+    }
+    return workspace.GetDistance(finish);
+  }
+
+  // Число извлечённых из очереди вершин за все запуски.
+  size_t SettledCount() const { return settled_; }
+
+  const Visitor& GetVisitor() const { return visitor_; }
+
+ private:
+  Visitor visitor_;
+  const Heuristic<VertexType, WeightType>& heuristic_;
+  size_t settled_ = 0;
+};
+
+// Граф с развёрнутыми рёбрами, достаточный для DijkstraSearch.
+template <typename Graph>
+class ReversedGraph {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using EdgeType = typename Graph::EdgeType;
+
+  explicit ReversedGraph(const Graph& graph)
+      : adjacent_(graph.VerticesCount()) {
+    for (size_t vertex = 0; vertex < adjacent_.size(); ++vertex) {
+      for (auto edge : graph.GetEdges(vertex)) {
+        std::swap(edge.first, edge.second);
+        adjacent_[edge.first].push_back(edge);
+      }
+    }
+  }
+
+  size_t VerticesCount() const { return adjacent_.size(); }
+
+  const std::vector<EdgeType>& GetEdges(const VertexType& vertex) const {
+    return adjacent_[vertex];
+  }
+
+ private:
+  std::vector<std::vector<EdgeType>> adjacent_;
+};
+
+// Расстояния от ориентиров и до них для ALT. Первый ориентир -- самая далёкая
+// вершина от вершины наибольшей степени, каждый следующий -- самая далёкая от
+// уже выбранных; недостижимые вершины не выбираются. Таблицы хранятся по
+// вершинам: строка вершины -- её расстояния до всех ориентиров подряд. Если
+// граф симметричен, обратная таблица совпадает с прямой и не хранится.
+template <typename Graph>
+class LandmarkTable {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using WeightType = typename Graph::EdgeType::WeightType;
+
+  static constexpr WeightType kInfinity =
+      SsspWorkspace<WeightType>::kInfinity;
+
+  LandmarkTable(const Graph& graph, size_t num_landmarks)
+      : num_vertices_(graph.VerticesCount()) {
+    if (num_vertices_ == 0) {
+      return;
+    }
+    ReversedGraph<Graph> reversed(graph);
+    bool symmetric = true;
+    size_t seed = 0;
+    size_t max_degree = 0;
+    for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+      auto edges = graph.GetEdges(vertex);
+      if (edges.size() > max_degree) {
+        max_degree = edges.size();
+        seed = vertex;
+      }
+      symmetric = symmetric && IsSameEdges(edges, reversed.GetEdges(vertex));
+    }
+    SsspWorkspace<WeightType> workspace;
+    DijkstraSearch<Graph, Visitor<Graph>>{}(graph, seed, workspace);
+    std::vector<WeightType> nearest(num_vertices_);
+    for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+      nearest[vertex] = workspace.GetDistance(vertex);
+    }
+    std::vector<std::vector<WeightType>> from;
+    std::vector<std::vector<WeightType>> to;
+    while (landmarks_.size() < num_landmarks) {
+      std::optional<size_t> farthest;
+      for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+        if ((nearest[vertex] != kInfinity) && (nearest[vertex] > 0) &&
+            (!farthest.has_value() || (nearest[vertex] > nearest[*farthest]))) {
+          farthest = vertex;
+        }
+      }
+      if (landmarks_.empty() && !farthest.has_value()) {
+        farthest = seed;
+      }
+      if (!farthest.has_value()) {
+        break;
+      }
+      if (landmarks_.empty()) {
+        std::fill(nearest.begin(), nearest.end(), kInfinity);
+      }
+      landmarks_.push_back(*farthest);
+      from.push_back(DijkstraSearch<Graph, Visitor<Graph>>{}(graph, *farthest));
+      if (!symmetric) {
+        to.push_back(DijkstraSearch<ReversedGraph<Graph>,
+                                    Visitor<ReversedGraph<Graph>>>{}(
+            reversed, *farthest));
+      }
+      for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+        nearest[vertex] = std::min(nearest[vertex], from.back()[vertex]);
+      }
+    }
+    from_ = Interleave(from);
+    to_ = Interleave(to);
+  }
+
+  size_t CountLandmarks() const { return landmarks_.size(); }
+
+  const std::vector<VertexType>& GetLandmarks() const { return landmarks_; }
+
+  // Строки из CountLandmarks() расстояний; kInfinity -- недостижимо.
+  const WeightType* FromLandmarks(const VertexType& vertex) const {
+    return from_.data() + vertex * landmarks_.size();
+  }
+
+  const WeightType* ToLandmarks(const VertexType& vertex) const {
+    return (to_.empty() ? from_ : to_).data() + vertex * landmarks_.size();
+  }
+
+ private:
+  template <typename First, typename Second>
+  static bool IsSameEdges(const First& first, const Second& second) {
+    std::vector<std::pair<VertexType, WeightType>> lhs;
+    std::vector<std::pair<VertexType, WeightType>> rhs;
+    for (const auto& edge : first) {
+      lhs.push_back({edge.second, edge.weight});
+    }
+    for (const auto& edge : second) {
+      rhs.push_back({edge.second, edge.weight});
+    }
+    std::sort(lhs.begin(), lhs.end());
+    std::sort(rhs.begin(), rhs.end());
+    return lhs == rhs;
+  }
+
+  std::vector<WeightType> Interleave(
+      const std::vector<std::vector<WeightType>>& columns) const {
+    std::vector<WeightType> res(columns.size() * num_vertices_);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      for (size_t vertex = 0; vertex < num_vertices_; ++vertex) {
+        res[vertex * columns.size() + i] = columns[i][vertex];
+      }
+    }
+    return res;
+  }
+
+  size_t num_vertices_;
+  std::vector<VertexType> landmarks_;
+  std::vector<WeightType> from_;
+  std::vector<WeightType> to_;
+};
+
+// Оценка ALT по неравенству треугольника: для ориентира L расстояние от v до
+// t не меньше d(L, t) - d(L, v) и d(v, L) - d(t, L). Монотонна, так что
+// годится для AStarSearch.
+template <typename Graph>
+class LandmarkHeuristic
+    : public Heuristic<typename Graph::VertexType,
+                       typename Graph::EdgeType::WeightType> {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using WeightType = typename Graph::EdgeType::WeightType;
+
+  LandmarkHeuristic(const LandmarkTable<Graph>& table, const VertexType& target)
+      : table_(table),
+        from_target_(table.FromLandmarks(target),
+                     table.FromLandmarks(target) + table.CountLandmarks()),
+        to_target_(table.ToLandmarks(target),
+                   table.ToLandmarks(target) + table.CountLandmarks()) {}
+
+  WeightType operator()(const VertexType& vertex) const override {
+    constexpr WeightType kInfinity = LandmarkTable<Graph>::kInfinity;
+    const WeightType* from = table_.FromLandmarks(vertex);
+    const WeightType* to = table_.ToLandmarks(vertex);
+    WeightType res = 0;
+    for (size_t i = 0; i < from_target_.size(); ++i) {
+      if ((from_target_[i] != kInfinity) && (from[i] != kInfinity)) {
+        res = std::max(res, from_target_[i] - from[i]);
+      }
+      if ((to[i] != kInfinity) && (to_target_[i] != kInfinity)) {
+        res = std::max(res, to[i] - to_target_[i]);
+      }
+    }
+    return res;
+  }
+
+ private:
+  const LandmarkTable<Graph>& table_;
+  std::vector<WeightType> from_target_;
+  std::vector<WeightType> to_target_;
+};
+
+// Ответ задачи для недостижимых вершин.
+constexpr int kUnreachable = 2009000999;
+
+// Граф в виде CSR: рёбра обоих направлений, упорядоченные по началу. Память
+// берётся из переданного ресурса, так что граф живёт в арене своего теста.
+template <typename Edge = WeightedEdge<>>
+class FlatGraph {
+ public:
+  using VertexType = size_t;
+  using EdgeType = Edge;
+
+  FlatGraph(size_t num_vertices, std::span<const Edge> edges,
+            std::pmr::memory_resource* resource)
+      : offsets_(num_vertices + 1, 0, resource),
+        edges_(2 * edges.size(), resource) {
+    for (const Edge& edge : edges) {
+      ++offsets_[edge.first + 1];
+      ++offsets_[edge.second + 1];
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    std::pmr::vector<size_t> filled(offsets_.begin(), offsets_.end() - 1,
+                                    resource);
+    for (const Edge& edge : edges) {
+      edges_[filled[edge.first]++] = edge;
+      edges_[filled[edge.second]++] = {edge.second, edge.first, edge.weight};
+    }
+  }
+
+  size_t VerticesCount() const { return offsets_.size() - 1; }
+
+  std::span<const Edge> GetEdges(size_t vertex) const {
+    return {edges_.data() + offsets_[vertex],
+            edges_.data() + offsets_[vertex + 1]};
+  }
+
+ private:
+  std::pmr::vector<size_t> offsets_;
+  std::pmr::vector<Edge> edges_;
+};
+
+// Тест пакетного режима. Рёбра, а потом и граф лежат в собственной арене
+// теста: рабочие потоки не делят аллокатор, а память освобождается разом.
+struct BatchInstance {
+  size_t index;
+  size_t num_vertices;
+  size_t start;
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+  std::pmr::vector<WeightedEdge<>> edges;
+};
+
+BatchInstance ReadInstance(size_t index) {
+  size_t num_vertices;
+  size_t num_edges;
+  std::cin >> num_vertices >> num_edges;
+  // Рёбра, CSR с рёбрами обоих направлений и два массива смещений.
+  size_t arena_size = 3 * num_edges * sizeof(WeightedEdge<>) +
+                      2 * (num_vertices + 1) * sizeof(size_t);
+  auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(
+      std::max<size_t>(arena_size, 1));
+  std::pmr::vector<WeightedEdge<>> edges(num_edges, arena.get());
+  for (auto& edge : edges) {
+    std::cin >> edge.first >> edge.second >> edge.weight;
+  }
+  size_t start;
+  std::cin >> start;
+  return {index, num_vertices, start, std::move(arena), std::move(edges)};
+}
+
+std::string SolveInstance(const BatchInstance& instance,
+                          SsspWorkspace<int>& workspace) {
+  FlatGraph<> graph(instance.num_vertices, instance.edges,
+                    instance.arena.get());
+  using Search = DijkstraSearch<FlatGraph<>, Visitor<FlatGraph<>>>;
+  Search{}(graph, instance.start, workspace);
+  std::string res;
+  for (size_t i = 0; i < instance.num_vertices; ++i) {
+    int dist = workspace.GetDistance(i);
+    res += std::to_string((dist == Search::kInfinity) ? kUnreachable : dist);
+    res += ' ';
+  }
+  res += '\n';
+  return res;
+}
+
+// Ограниченная очередь между читающим потоком и рабочими: чтение не уходит
+// дальше чем на capacity тестов вперёд.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  void Push(T item) {
+    std::unique_lock lock(mutex_);
+    not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  // Пустой результат -- очередь закрыта и разобрана.
+  std::optional<T> Pop() {
+    std::unique_lock lock(mutex_);
+    not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    T item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return item;
+  }
+
+  void Close() {
+    std::lock_guard lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  size_t capacity_;
+  bool closed_ = false;
+};
+
+// Выводит результаты в порядке номеров: готовый результат ждёт, пока не
+// выведены все предыдущие, и выводится тем потоком, который закрыл пропуск.
+class OrderedOutput {
+ public:
+  explicit OrderedOutput(std::ostream& out) : out_(out) {}
+
+  void Put(size_t index, std::string text) {
+    std::lock_guard lock(mutex_);
+    pending_.emplace(index, std::move(text));
+    while (!pending_.empty() && (pending_.begin()->first == next_)) {
+      out_ << pending_.begin()->second;
+      pending_.erase(pending_.begin());
+      ++next_;
+    }
+  }
+
+ private:
+  std::ostream& out_;
+  std::mutex mutex_;
+  std::map<size_t, std::string> pending_;
+  size_t next_ = 0;
+};
+
+// Главный поток читает тесты, рабочие решают их со своими SsspWorkspace.
+void RunBatch(size_t num_graphs, size_t num_threads) {
+  num_threads = std::max<size_t>(1, num_threads);
+  BoundedQueue<BatchInstance> queue(4 * num_threads);
+  OrderedOutput output(std::cout);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers.emplace_back([&queue, &output] {
+      SsspWorkspace<int> workspace;
+      while (auto instance = queue.Pop()) {
+        output.Put(instance->index, SolveInstance(*instance, workspace));
+      }
+    });
+  }
+  for (size_t t = 0; t < num_graphs; ++t) {
+    queue.Push(ReadInstance(t));
+  }
+  queue.Close();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  std::cout.flush();
+}
+
+// Кэш результатов DijkstraSearch для повторяющихся источников: на источник
+// хранятся плоские массивы расстояний и предков, при нехватке памяти
+// вытесняется давно не использованный. Вершины -- числа из [0, n).
+template <typename Graph>
+class ShortestPathCache {
+ public:
+  using VertexType = typename Graph::VertexType;
+  using WeightType = typename Graph::EdgeType::WeightType;
+
+  static constexpr WeightType kInfinity =
+      SsspWorkspace<WeightType>::kInfinity;
+  static constexpr size_t kNoParent = SsspWorkspace<WeightType>::kNoParent;
+
+  struct Tree {
+    std::vector<WeightType> dist;
+    std::vector<size_t> parents;
+  };
+
+  ShortestPathCache(const Graph& graph, size_t memory_limit)
+      : graph_(graph),
+        capacity_(std::max<size_t>(
+            1, memory_limit / std::max<size_t>(1, TreeMemory()))) {}
+
+  const Tree& Get(VertexType start) {
+    auto found = index_.find(start);
+    if (found != index_.end()) {
+      ++hits_;
+      trees_.splice(trees_.begin(), trees_, found->second);
+      return found->second->second;
+    }
+    ++misses_;
+    if (trees_.size() == capacity_) {
+      index_.erase(trees_.back().first);
+      trees_.pop_back();
+    }
+    trees_.emplace_front(start, BuildTree(start));
+    index_[start] = trees_.begin();
+    return trees_.front().second;
+  }
+
+  size_t Hits() const { return hits_; }
+
+  size_t Misses() const { return misses_; }
+
+ private:
+  size_t TreeMemory() const {
+    return graph_.VerticesCount() * (sizeof(WeightType) + sizeof(size_t));
+  }
+
+  Tree BuildTree(VertexType start) {
+    DijkstraSearch<Graph, Visitor<Graph>>{}(graph_, start, workspace_);
+    Tree res{std::vector<WeightType>(graph_.VerticesCount()),
+             std::vector<size_t>(graph_.VerticesCount())};
+    for (size_t vertex = 0; vertex < graph_.VerticesCount(); ++vertex) {
+      res.dist[vertex] = workspace_.GetDistance(vertex);
+      res.parents[vertex] = workspace_.GetParent(vertex);
+    }
+    return res;
+  }
+
+  const Graph& graph_;
+  size_t capacity_;
+  std::list<std::pair<VertexType, Tree>> trees_;
+  std::unordered_map<VertexType, typename decltype(trees_)::iterator> index_;
+  SsspWorkspace<WeightType> workspace_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+// Гистограмма задержек: корзина 0 -- меньше микросекунды, корзина i --
+// от 2^(i - 1) до 2^i микросекунд.
+class LatencyHistogram {
+ public:
+  void Add(std::chrono::nanoseconds latency) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency)
+                      .count();
+    size_t bucket = std::bit_width(static_cast<uint64_t>(micros));
+    ++buckets_[std::min(bucket, kBuckets - 1)];
+  }
+
+  void Print(std::ostream& out) const {
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      if (buckets_[bucket] != 0) {
+        out << "< " << (uint64_t{1} << bucket) << " us: " << buckets_[bucket]
+            << "\n";
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kBuckets = 40;
+
+  std::array<size_t, kBuckets> buckets_{};
+};
+
+// Обработчик запросов резидентного режима. Запрос -- строка
+// "source target [path]", ответ -- расстояние и, если просили, вершины пути;
+// строка "stats" возвращает гистограмму задержек и счётчики кэша.
+class QueryServer {
+ public:
+  QueryServer(const FlatGraph<>& graph, size_t memory_limit)
+      : graph_(graph), cache_(graph, memory_limit) {}
+
+  std::string Handle(const std::string& line) {
+    if (line == "stats") {
+      return Stats();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    std::istringstream query(line);
+    size_t source;
+    size_t target;
+    std::string option;
+    if (!(query >> source >> target) ||
+        (source >= graph_.VerticesCount()) ||
+        (target >= graph_.VerticesCount()) ||
+        ((query >> option) && (option != "path"))) {
+      return "error\n";
+    }
+    const auto& tree = cache_.Get(source);
+    std::string res;
+    if (tree.dist[target] == cache_.kInfinity) {
+      res = std::to_string(kUnreachable);
+    } else {
+      res = std::to_string(tree.dist[target]);
+      if (option == "path") {
+        std::vector<size_t> path;
+        for (size_t vertex = target; vertex != cache_.kNoParent;
+             vertex = tree.parents[vertex]) {
+          path.push_back(vertex);
+        }
+        for (auto vertex = path.rbegin(); vertex != path.rend(); ++vertex) {
+          res += ' ' + std::to_string(*vertex);
+        }
+      }
+    }
+    res += '\n';
+    latencies_.Add(std::chrono::steady_clock::now() - begin);
+    return res;
+  }
+
+  std::string Stats() const {
+    std::ostringstream out;
+    latencies_.Print(out);
+    out << "hits: " << cache_.Hits() << " misses: " << cache_.Misses()
+        << "\n";
+    return out.str();
+  }
+
+ private:
+  const FlatGraph<>& graph_;
+  ShortestPathCache<FlatGraph<>> cache_;
+  LatencyHistogram latencies_;
+};
+
+// Обслуживает клиентов Unix-сокета по одному, пока accept не откажет.
+bool ServeSocket(const char* path, QueryServer& server) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (std::strlen(path) >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::strcpy(address.sun_path, path);
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    return false;
+  }
+  unlink(path);
+  if ((bind(listener, reinterpret_cast<sockaddr*>(&address),
+            sizeof(address)) < 0) ||
+      (listen(listener, SOMAXCONN) < 0)) {
+    close(listener);
+    return false;
+  }
+  while (true) {
+    int client = accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    std::string buffer;
+    char chunk[1 << 12];
+    ssize_t len;
+    bool alive = true;
+    while (alive && ((len = read(client, chunk, sizeof(chunk))) > 0)) {
+      buffer.append(chunk, len);
+      size_t end;
+      while (alive && ((end = buffer.find('\n')) != std::string::npos)) {
+        std::string answer = server.Handle(buffer.substr(0, end));
+        buffer.erase(0, end + 1);
+        for (size_t sent = 0; alive && (sent < answer.size());) {
+          ssize_t res = send(client, answer.data() + sent,
+                             answer.size() - sent, MSG_NOSIGNAL);
+          alive = (res > 0);
+          sent += alive ? res : 0;
+        }
+      }
+    }
+    close(client);
+  }
+  close(listener);
+  return false;
+}
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   std::ios_base::sync_with_stdio(false);
   std::cin.tie(0);
+  if (mode == "--server") {
+    constexpr size_t kDefaultCacheMegabytes = 256;
+    size_t memory_limit =
+        ((argc > 3) ? std::stoull(argv[3]) : kDefaultCacheMegabytes) << 20;
+    size_t num_vertices;
+    size_t num_edges;
+    std::cin >> num_vertices >> num_edges;
+    std::vector<WeightedEdge<>> edges(num_edges);
+    for (auto& edge : edges) {
+      std::cin >> edge.first >> edge.second >> edge.weight;
+    }
+    FlatGraph<> graph(num_vertices, edges, std::pmr::get_default_resource());
+    QueryServer server(graph, memory_limit);
+    if ((argc > 2) && (std::string(argv[2]) != "-")) {
+      if (!ServeSocket(argv[2], server)) {
+        std::cerr << "cannot serve " << argv[2] << std::endl;
+        return 1;
+      }
+      return 0;
+    }
+    std::string line;
+    std::getline(std::cin, line);
+    while (std::getline(std::cin, line)) {
+      std::cout << server.Handle(line) << std::flush;
+    }
+    std::cerr << server.Stats();
+    return 0;
+  }
   size_t num_graphs;
   std::cin >> num_graphs;
+  if (mode == "--batch") {
+    RunBatch(num_graphs, (argc > 2) ? std::stoull(argv[2])
+                                    : std::thread::hardware_concurrency());
+    return 0;
+  }
+  SsspWorkspace<int> workspace;
   for (size_t t = 0; t < num_graphs; ++t) {
     size_t num_vertices;
     size_t num_edges;
@@ -289,17 +1144,37 @@ int main() {
       std::cin >> edges[i].first >> edges[i].second >> edges[i].weight;
     }
     ListGraph<size_t, WeightedEdge<>> graph(vertices, edges);
+    if (mode == "--alt") {
+      size_t num_landmarks = (argc > 2) ? std::stoull(argv[2]) : 8;
+      LandmarkTable<decltype(graph)> table(graph, num_landmarks);
+      size_t num_queries;
+      std::cin >> num_queries;
+      size_t settled = 0;
+      for (size_t i = 0; i < num_queries; ++i) {
+        size_t start;
+        size_t finish;
+        std::cin >> start >> finish;
+        LandmarkHeuristic<decltype(graph)> heuristic(table, finish);
+        AStarSearch<decltype(graph), Visitor<decltype(graph)>> search(
+            heuristic);
+        int dist = search(graph, start, finish, workspace);
+        std::cout << ((dist == search.kInfinity) ? kUnreachable : dist)
+                  << std::endl;
+        settled += search.SettledCount();
+      }
+      std::cerr << "landmarks: " << table.CountLandmarks()
+                << " settled: " << settled << std::endl;
+      continue;
+    }
     size_t start;
     std::cin >> start;
-    auto res =
-        DijkstraSearch<decltype(graph), DistanceVisitor<decltype(graph)>>{}(
-            graph, start);
-    constexpr int kInfinity = 2009000999;
+    using Search = DijkstraSearch<decltype(graph), Visitor<decltype(graph)>>;
+    Search{}(graph, start, workspace);
     for (size_t i = 0; i < num_vertices; ++i) {
-      if (res.count(i) == 0) {
-        std::cout << kInfinity << " ";
+      if (workspace.GetDistance(i) == Search::kInfinity) {
+        std::cout << kUnreachable << " ";
       } else {
-        std::cout << res[i] << " ";
+        std::cout << workspace.GetDistance(i) << " ";
       }
     }
     std::cout << std::endl;
@@ -1,99 +1,570 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <limits>
-#include <queue>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-using Vertex = size_t;
 using Weight = uint64_t;
 
+template <typename Index>
+Index CheckedIndex(size_t value) {
+  static_assert(std::is_unsigned_v<Index>, "index type must be unsigned");
+  if (value > std::numeric_limits<Index>::max()) {
+    throw std::overflow_error("index does not fit into the index type");
+  }
+  return static_cast<Index>(value);
+}
+
+template <typename Index = uint32_t>
 struct Edge {
-  Vertex first;
-  Vertex second;
-  uint64_t weight;
+  Index first;
+  Index second;
+  Weight weight;
 };
 
-using Graph = std::vector<std::vector<Edge>>;
-
-std::vector<Weight> FindLengths(const Graph& graph,
-                                const std::vector<Vertex>& starts) {
-  constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
-  std::vector<Weight> dist(graph.size(), kInfinity);
-  std::priority_queue<std::pair<Weight, Vertex>,
-                      std::vector<std::pair<Weight, Vertex>>,
-                      std::greater<std::pair<Weight, Vertex>>>
-      queue;
-  for (Vertex start : starts) {
-    dist[start] = 0;
-    queue.push({0, start});
-  }
-  std::vector<bool> used(graph.size(), false);
-  while (!queue.empty()) {
-    Vertex cur = queue.top().second;
-    queue.pop();
-    if (used[cur]) {
-      continue;
+template <typename Index = uint32_t>
+using Graph = std::vector<std::vector<Edge<Index>>>;
+
+// Четверичная куча над индексами из [0, n) с уменьшением ключа. Позиции
+// индексов хранятся в плоском массиве, так что каждый индекс лежит в куче не
+// больше одного раза.
+template <typename Key>
+class IndexedHeap {
+ public:
+  explicit IndexedHeap(size_t num_indices = 0)
+      : positions_(num_indices, kAbsent) {}
+
+  bool Empty() const { return items_.empty(); }
+
+  size_t Size() const { return items_.size(); }
+
+  bool Contains(size_t index) const {
+    return (index < positions_.size()) && (positions_[index] != kAbsent);
+  }
+
+  // Добавляет индекс либо уменьшает его ключ; больший ключ игнорируется.
+  void Push(size_t index, Key key) {
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    size_t pos = positions_[index];
+    if (pos == kAbsent) {
+      pos = items_.size();
+      items_.push_back({key, index});
+    } else if (key < items_[pos].first) {
+      items_[pos].first = key;
+    } else {
+      return;
+    }
+    SiftUp(pos);
+  }
+
+  std::pair<Key, size_t> Pop() {
+    std::pair<Key, size_t> res = items_.front();
+    positions_[res.second] = kAbsent;
+    items_.front() = items_.back();
+    items_.pop_back();
+    if (!items_.empty()) {
+      positions_[items_.front().second] = 0;
+      SiftDown(0);
+    }
+    return res;
+  }
+
+  void Clear() {
+    for (const auto& item : items_) {
+      positions_[item.second] = kAbsent;
+    }
+    items_.clear();
+  }
+
+ private:
+  static constexpr size_t kArity = 4;
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  void SiftUp(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / kArity;
+      if (!(item.first < items_[parent].first)) {
+        break;
+      }
+      Place(pos, items_[parent]);
+      pos = parent;
+    }
+    Place(pos, item);
+  }
+
+  void SiftDown(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (true) {
+      size_t first_child = pos * kArity + 1;
+      if (first_child >= items_.size()) {
+        break;
+      }
+      size_t last_child = std::min(first_child + kArity, items_.size());
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (items_[child].first < items_[best].first) {
+          best = child;
+        }
+      }
+      if (!(items_[best].first < item.first)) {
+        break;
+      }
+      Place(pos, items_[best]);
+      pos = best;
+    }
+    Place(pos, item);
+  }
+
+  void Place(size_t pos, const std::pair<Key, size_t>& item) {
+    items_[pos] = item;
+    positions_[item.second] = pos;
+  }
+
+  std::vector<std::pair<Key, size_t>> items_;
+  std::vector<size_t> positions_;
+};
+
+// Радиксная куча для монотонных целых ключей: запись лежит в корзине по
+// старшему биту, которым её ключ отличается от последнего извлечённого.
+// Интерфейс как у IndexedHeap; при уменьшении ключа добавляется новая
+// запись, а устаревшая пропускается. Ключи в Push не меньше последнего
+// извлечённого.
+template <typename Key>
+class RadixHeap {
+  static_assert(std::is_unsigned_v<Key>, "radix heap keys must be unsigned");
+
+ public:
+  explicit RadixHeap(size_t num_indices = 0)
+      : keys_(num_indices), queued_(num_indices, 0) {}
+
+  bool Empty() const { return size_ == 0; }
+
+  size_t Size() const { return size_; }
+
+  bool Contains(size_t index) const {
+    return (index < queued_.size()) && (queued_[index] != 0);
+  }
+
+  void Push(size_t index, Key key) {
+    if (key < last_) {
+      throw std::logic_error("radix heap keys must be monotone");
+    }
+    if (index >= queued_.size()) {
+      keys_.resize(index + 1);
+      queued_.resize(index + 1, 0);
+    }
+    if (queued_[index] == 0) {
+      queued_[index] = 1;
+      ++size_;
+    } else if (key >= keys_[index]) {
+      return;
+    }
+    keys_[index] = key;
+    buckets_[Bucket(key)].push_back({key, index});
+  }
+
+  std::pair<Key, size_t> Pop() {
+    while (true) {
+      if (buckets_[0].empty()) {
+        Redistribute();
+      }
+      std::pair<Key, size_t> item = buckets_[0].back();
+      buckets_[0].pop_back();
+      if (IsCurrent(item)) {
+        queued_[item.second] = 0;
+        --size_;
+        return item;
+      }
+    }
+  }
+
+  void Clear() {
+    for (auto& bucket : buckets_) {
+      for (const auto& item : bucket) {
+        queued_[item.second] = 0;
+      }
+      bucket.clear();
+    }
+    size_ = 0;
+    last_ = 0;
+  }
+
+ private:
+  static constexpr size_t kBuckets = std::numeric_limits<Key>::digits + 1;
+
+  size_t Bucket(Key key) const { return std::bit_width<Key>(key ^ last_); }
+
+  bool IsCurrent(const std::pair<Key, size_t>& item) const {
+    return (queued_[item.second] != 0) && (keys_[item.second] == item.first);
+  }
+
+  // Минимум первой корзины с актуальными записями становится последним
+  // ключом, а её записи расходятся по корзинам с меньшими номерами.
+  void Redistribute() {
+    for (size_t bucket = 1; bucket < kBuckets; ++bucket) {
+      std::optional<Key> min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item) && (!min.has_value() || (item.first < *min))) {
+          min = item.first;
+        }
+      }
+      if (!min.has_value()) {
+        buckets_[bucket].clear();
+        continue;
+      }
+      last_ = *min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item)) {
+          buckets_[Bucket(item.first)].push_back(item);
+        }
+      }
+      buckets_[bucket].clear();
+      return;
+    }
+  }
+
+  std::array<std::vector<std::pair<Key, size_t>>, kBuckets> buckets_;
+  std::vector<Key> keys_;
+  std::vector<uint8_t> queued_;
+  size_t size_ = 0;
+  Key last_ = 0;
+};
+
+// Состояние поиска кратчайших путей, переиспользуемое между запросами.
+// Вместо очистки массивов увеличивается номер эпохи: значения с устаревшей
+// отметкой считаются сброшенными, так что запрос стоит столько, сколько
+// вершин он затронул.
+template <typename Weight, typename Queue = IndexedHeap<Weight>>
+class SsspWorkspace {
+ public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+  explicit SsspWorkspace(size_t num_vertices = 0) { Reset(num_vertices); }
+
+  void Reset(size_t num_vertices) {
+    if (num_vertices > dist_.size()) {
+      dist_.resize(num_vertices);
+      parents_.resize(num_vertices);
+      dist_stamps_.resize(num_vertices, 0);
+      visited_stamps_.resize(num_vertices, 0);
     }
-    used[cur] = true;
-    for (Edge edge : graph[cur]) {
-      dist[edge.second] = std::min(dist[edge.second], dist[cur] + edge.weight);
-      queue.push({dist[edge.second], edge.second});
+    queue_.Clear();
+    if (++epoch_ == 0) {
+      std::fill(dist_stamps_.begin(), dist_stamps_.end(), 0);
+      std::fill(visited_stamps_.begin(), visited_stamps_.end(), 0);
+      epoch_ = 1;
     }
   }
+
+  Weight GetDistance(size_t vertex) const {
+    return (dist_stamps_[vertex] == epoch_) ? dist_[vertex] : kInfinity;
+  }
+
+  size_t GetParent(size_t vertex) const {
+    return (dist_stamps_[vertex] == epoch_) ? parents_[vertex] : kNoParent;
+  }
+
+  void SetDistance(size_t vertex, Weight dist, size_t parent = kNoParent) {
+    dist_[vertex] = dist;
+    parents_[vertex] = parent;
+    dist_stamps_[vertex] = epoch_;
+  }
+
+  bool IsVisited(size_t vertex) const {
+    return visited_stamps_[vertex] == epoch_;
+  }
+
+  void MarkVisited(size_t vertex) { visited_stamps_[vertex] = epoch_; }
+
+  Queue& GetQueue() { return queue_; }
+
+ private:
+  std::vector<Weight> dist_;
+  std::vector<size_t> parents_;
+  std::vector<uint32_t> dist_stamps_;
+  std::vector<uint32_t> visited_stamps_;
+  uint32_t epoch_ = 0;
+  Queue queue_;
+};
+
+template <typename Index, typename Queue>
+std::vector<Weight> FindLengths(const Graph<Index>& graph,
+                                const std::vector<Index>& starts,
+                                SsspWorkspace<Weight, Queue>& workspace) {
+  workspace.Reset(graph.size());
+  Queue& queue = workspace.GetQueue();
+  for (Index start : starts) {
+    workspace.SetDistance(start, 0);
+    queue.Push(start, 0);
+  }
+  while (!queue.Empty()) {
+    auto [cur_dist, cur] = queue.Pop();
+    for (Edge<Index> edge : graph[cur]) {
+      if (cur_dist + edge.weight < workspace.GetDistance(edge.second)) {
+        workspace.SetDistance(edge.second, cur_dist + edge.weight);
+        queue.Push(edge.second, cur_dist + edge.weight);
+      }
+    }
+  }
+  std::vector<Weight> dist(graph.size());
+  for (size_t vertex = 0; vertex < dist.size(); ++vertex) {
+    dist[vertex] = workspace.GetDistance(vertex);
+  }
   return dist;
 }
 
-std::vector<Weight> FindPath(const Graph& graph, Vertex start,
-                             const std::vector<Weight>& infect) {
-  constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
-  std::vector<Weight> dist(graph.size(), kInfinity);
-  std::priority_queue<std::pair<Weight, Vertex>,
-                      std::vector<std::pair<Weight, Vertex>>,
-                      std::greater<std::pair<Weight, Vertex>>>
-      queue;
-  dist[start] = 0;
-  queue.push({0, start});
-  std::vector<bool> used(graph.size(), false);
-  while (!queue.empty()) {
-    Vertex cur = queue.top().second;
-    queue.pop();
-    if (used[cur]) {
-      continue;
+// Поиск останавливается, как только расстояние до finish окончательно.
+template <typename Index, typename Queue>
+Weight FindPath(const Graph<Index>& graph, Index start, Index finish,
+                const std::vector<Weight>& infect,
+                SsspWorkspace<Weight, Queue>& workspace) {
+  workspace.Reset(graph.size());
+  Queue& queue = workspace.GetQueue();
+  workspace.SetDistance(start, 0);
+  queue.Push(start, 0);
+  while (!queue.Empty()) {
+    auto [cur_dist, cur] = queue.Pop();
+    if (cur == finish) {
+      break;
     }
-    if (dist[cur] >= infect[cur]) {
+    if (cur_dist >= infect[cur]) {
       continue;
     }
-    used[cur] = true;
-    for (Edge edge : graph[cur]) {
-      if ((dist[edge.second] > dist[cur] + edge.weight) &&
-          (dist[cur] + edge.weight < infect[edge.second])) {
-        dist[edge.second] = dist[cur] + edge.weight;
-        queue.push({dist[edge.second], edge.second});
+    for (Edge<Index> edge : graph[cur]) {
+      if ((workspace.GetDistance(edge.second) > cur_dist + edge.weight) &&
+          (cur_dist + edge.weight < infect[edge.second])) {
+        workspace.SetDistance(edge.second, cur_dist + edge.weight);
+        queue.Push(edge.second, cur_dist + edge.weight);
       }
     }
   }
-  return dist;
+  return workspace.GetDistance(finish);
 }
 
-int main() {
+// Параллельный delta-stepping (Meyer--Sanders). Вершины лежат в корзинах
+// ширины delta; лёгкие рёбра (не тяжелее delta) релаксируются фазами, пока
+// текущая корзина не опустеет, тяжёлые -- один раз после этого. Расстояния
+// уменьшаются атомарным минимумом, новые кандидаты копятся в списках потоков.
+// for_each_edge(vertex, relax) вызывает relax(next, weight) для каждого ребра;
+// admissible(vertex, dist) отсекает недопустимые расстояния.
+template <typename Weight>
+class DeltaStepping {
+ public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  DeltaStepping(Weight delta, size_t num_threads)
+      : delta_(std::max<Weight>(1, delta)),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  // Ширина корзины порядка максимального веса, делённого на среднюю степень.
+  static Weight AutoDelta(Weight max_weight, size_t num_vertices,
+                          size_t num_edges) {
+    size_t degree =
+        std::max<size_t>(1, num_edges / std::max<size_t>(1, num_vertices));
+    return std::max<Weight>(1, max_weight / degree);
+  }
+
+  template <typename ForEachEdge>
+  std::vector<Weight> operator()(size_t num_vertices,
+                                 const std::vector<size_t>& starts,
+                                 ForEachEdge for_each_edge) const {
+    return (*this)(num_vertices, starts, for_each_edge,
+                   [](size_t /*unused*/, Weight /*unused*/) { return true; });
+  }
+
+  template <typename ForEachEdge, typename Admissible>
+  std::vector<Weight> operator()(size_t num_vertices,
+                                 const std::vector<size_t>& starts,
+                                 ForEachEdge for_each_edge,
+                                 Admissible admissible) const {
+    std::vector<std::atomic<Weight>> dist(num_vertices);
+    for (auto& value : dist) {
+      value.store(kInfinity, std::memory_order_relaxed);
+    }
+    std::map<Weight, std::vector<size_t>> buckets;
+    for (size_t start : starts) {
+      dist[start].store(0, std::memory_order_relaxed);
+      buckets[0].push_back(start);
+    }
+    std::vector<std::vector<size_t>> requests(num_threads_);
+    while (!buckets.empty()) {
+      auto node = buckets.extract(buckets.begin());
+      Weight index = node.key();
+      std::vector<size_t> frontier = std::move(node.mapped());
+      std::vector<size_t> settled;
+      while (!frontier.empty()) {
+        std::sort(frontier.begin(), frontier.end());
+        frontier.erase(std::unique(frontier.begin(), frontier.end()),
+                       frontier.end());
+        std::erase_if(frontier, [&](size_t vertex) {
+          Weight value = dist[vertex].load(std::memory_order_relaxed);
+          return (value / delta_ != index) || !admissible(vertex, value);
+        });
+        settled.insert(settled.end(), frontier.begin(), frontier.end());
+        Relax(frontier, true, dist, requests, for_each_edge, admissible);
+        frontier.clear();
+        for (auto& list : requests) {
+          for (size_t vertex : list) {
+            Weight bucket =
+                dist[vertex].load(std::memory_order_relaxed) / delta_;
+            (bucket == index ? frontier : buckets[bucket]).push_back(vertex);
+          }
+          list.clear();
+        }
+      }
+      std::sort(settled.begin(), settled.end());
+      settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+      Relax(settled, false, dist, requests, for_each_edge, admissible);
+      for (auto& list : requests) {
+        for (size_t vertex : list) {
+          buckets[dist[vertex].load(std::memory_order_relaxed) / delta_]
+              .push_back(vertex);
+        }
+        list.clear();
+      }
+    }
+    std::vector<Weight> res(num_vertices);
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      res[vertex] = dist[vertex].load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kMinParallelFrontier = 1024;
+
+  template <typename ForEachEdge, typename Admissible>
+  void Relax(const std::vector<size_t>& vertices, bool light,
+             std::vector<std::atomic<Weight>>& dist,
+             std::vector<std::vector<size_t>>& requests,
+             ForEachEdge& for_each_edge, Admissible& admissible) const {
+    auto body = [&](size_t thread, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        Weight base = dist[vertices[i]].load(std::memory_order_relaxed);
+        for_each_edge(vertices[i], [&](size_t next, Weight weight) {
+          if ((weight <= delta_) != light) {
+            return;
+          }
+          Weight candidate = base + weight;
+          if (admissible(next, candidate) && AtomicMin(dist[next], candidate)) {
+            requests[thread].push_back(next);
+          }
+        });
+      }
+    };
+    if ((num_threads_ == 1) || (vertices.size() < kMinParallelFrontier)) {
+      body(0, 0, vertices.size());
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (vertices.size() + num_threads_ - 1) / num_threads_;
+    for (size_t thread = 1; thread < num_threads_; ++thread) {
+      size_t begin = std::min(vertices.size(), thread * chunk);
+      size_t end = std::min(vertices.size(), begin + chunk);
+      workers.emplace_back(body, thread, begin, end);
+    }
+    body(0, 0, std::min(vertices.size(), chunk));
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  static bool AtomicMin(std::atomic<Weight>& value, Weight candidate) {
+    Weight current = value.load(std::memory_order_relaxed);
+    while (candidate < current) {
+      if (value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Weight delta_;
+  size_t num_threads_;
+};
+
+template <typename Index>
+std::vector<Weight> FindLengths(const Graph<Index>& graph,
+                                const std::vector<Index>& starts,
+                                const DeltaStepping<Weight>& engine) {
+  return engine(graph.size(), {starts.begin(), starts.end()},
+                [&graph](size_t vertex, auto relax) {
+                  for (Edge<Index> edge : graph[vertex]) {
+                    relax(edge.second, edge.weight);
+                  }
+                });
+}
+
+template <typename Index>
+std::vector<Weight> FindPath(const Graph<Index>& graph, Index start,
+                             const std::vector<Weight>& infect,
+                             const DeltaStepping<Weight>& engine) {
+  return engine(
+      graph.size(), {start},
+      [&graph](size_t vertex, auto relax) {
+        for (Edge<Index> edge : graph[vertex]) {
+          relax(edge.second, edge.weight);
+        }
+      },
+      [&infect](size_t vertex, Weight dist) { return dist < infect[vertex]; });
+}
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   size_t num_vertices, num_edges, num_sources;
   std::cin >> num_vertices >> num_edges >> num_sources;
-  Graph graph(num_vertices, std::vector<Edge>());
+  using Vertex = decltype(Edge<>::first);
+  Graph<> graph(CheckedIndex<Vertex>(num_vertices));
   std::vector<Vertex> infected(num_sources);
   for (size_t i = 0; i < num_sources; ++i) {
     std::cin >> infected[i];
     --infected[i];
   }
+  Weight max_weight = 0;
   for (size_t i = 0; i < num_edges; ++i) {
     Vertex first, second;
     Weight weight;
     std::cin >> first >> second >> weight;
     graph[first - 1].push_back({first - 1, second - 1, weight});
     graph[second - 1].push_back({second - 1, first - 1, weight});
+    max_weight = std::max(max_weight, weight);
   }
-  auto infect_time = FindLengths(graph, infected);
   Vertex start, target;
   std::cin >> start >> target;
-  Weight res = FindPath(graph, start - 1, infect_time)[target - 1];
+  Weight res;
+  if (mode == "--delta-stepping") {
+    size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                    : std::thread::hardware_concurrency();
+    DeltaStepping<Weight> engine(
+        DeltaStepping<Weight>::AutoDelta(max_weight, num_vertices,
+                                         2 * num_edges),
+        num_threads);
+    res = FindPath(graph, start - 1, FindLengths(graph, infected, engine),
+                   engine)[target - 1];
+  } else if (mode == "--radix-heap") {
+    SsspWorkspace<Weight, RadixHeap<Weight>> workspace(graph.size());
+    auto infect_time = FindLengths(graph, infected, workspace);
+    res = FindPath(graph, start - 1, target - 1, infect_time, workspace);
+  } else {
+    SsspWorkspace<Weight> workspace(graph.size());
+    auto infect_time = FindLengths(graph, infected, workspace);
+    res = FindPath(graph, start - 1, target - 1, infect_time, workspace);
+  }
   if (res == std::numeric_limits<Weight>::max()) {
     std::cout << -1 << std::endl;
   } else {
@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <optional>
 #include <queue>
+#include <tuple>
 #include <vector>
 
 using Vertex = size_t;
@@ -18,48 +20,133 @@ struct Edge {
 
 using Graph = std::vector<std::vector<Edge>>;
 
-struct State {
+// Дешевейший путь с ограничением по времени. На вершину хранятся
+// Парето-оптимальные по (цена, время) метки из общего пула, путь
+// восстанавливается по индексам родительских меток. Метки извлекаются по
+// возрастанию цены, так что первая извлечённая метка в finish оптимальна.
+// Метка отбрасывается, если её доминирует метка той же вершины или если
+// даже самый быстрый путь от её вершины до finish не успевает к max_time.
+class ParetoPathSearch {
+ public:
   static constexpr size_t kInfinity = std::numeric_limits<size_t>::max();
 
-  Vertex vertex;
-  size_t price;
-  size_t time;
-  std::vector<Vertex> path;
+  struct Path {
+    size_t price;
+    std::vector<Vertex> vertices;
+  };
+
+  explicit ParetoPathSearch(const Graph& graph) : graph_(graph) {}
+
+  std::optional<Path> operator()(Vertex start, Vertex finish,
+                                 size_t max_time) {
+    labels_.clear();
+    fronts_.assign(graph_.size(), {});
+    min_time_ = FastestTimes(finish);
+    if (min_time_[start] > max_time) {
+      return std::nullopt;
+    }
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>>
+        queue;
+    AddLabel({start, 0, 0, kNoParent}, queue);
+    while (!queue.empty()) {
+      size_t index = std::get<2>(queue.top());
+      queue.pop();
+      if (labels_[index].dominated) {
+        continue;
+      }
+      Label label = labels_[index];
+      if (label.vertex == finish) {
+        return Rebuild(index);
+      }
+      for (Edge edge : graph_[label.vertex]) {
+        if ((min_time_[edge.second] != kInfinity) &&
+            (label.time + edge.time + min_time_[edge.second] <= max_time)) {
+          AddLabel({edge.second, label.price + edge.price,
+                    label.time + edge.time, index},
+                   queue);
+        }
+      }
+    }
+    return std::nullopt;
+  }
 
-  State(Vertex vertex, size_t price = kInfinity, size_t time = kInfinity,
-        const std::vector<Vertex>& path = {})
-      : vertex(vertex), price(price), time(time), path(path) {}
+  // Размер пула меток последнего поиска.
+  size_t CountLabels() const { return labels_.size(); }
 
-  State() = default;
+ private:
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
 
-  bool Empty() { return path.empty(); }
-};
+  struct Label {
+    Vertex vertex;
+    size_t price;
+    size_t time;
+    size_t parent;
+    bool dominated = false;
+  };
+
+  // (цена, время, индекс метки).
+  using QueueItem = std::tuple<size_t, size_t, size_t>;
 
-State FindPath(const Graph& graph, Vertex start, Vertex finish,
-               size_t max_time) {
-  std::vector<State> opt(graph.size());
-  std::generate(opt.begin(),
-                opt.end(), [vertex = 0]() mutable { return State(vertex++); });
-  opt[start] = State(start, 0, 0, {start});
-  auto cmp = [](State a, State b) { return a.time > b.time; };
-  std::priority_queue<State, std::vector<State>, decltype(cmp)> queue(cmp);
-  queue.push(opt[start]);
-  while (!queue.empty()) {
-    State cur = queue.top();
-    queue.pop();
-    for (Edge next : graph[cur.vertex]) {
-      if ((opt[next.second].price > opt[next.first].price + next.price) &&
-          (opt[next.first].time + next.time <= max_time)) {
-        opt[next.second].price = opt[next.first].price + next.price;
-        opt[next.second].path = opt[next.first].path;
-        opt[next.second].path.push_back(next.second);
-        opt[next.second].time = opt[next.first].time + next.time;
-        queue.push(opt[next.second]);
+  void AddLabel(Label label,
+                std::priority_queue<QueueItem, std::vector<QueueItem>,
+                                    std::greater<>>& queue) {
+    auto& front = fronts_[label.vertex];
+    for (size_t other : front) {
+      if ((labels_[other].price <= label.price) &&
+          (labels_[other].time <= label.time)) {
+        return;
       }
     }
+    std::erase_if(front, [&](size_t other) {
+      if ((label.price <= labels_[other].price) &&
+          (label.time <= labels_[other].time)) {
+        labels_[other].dominated = true;
+        return true;
+      }
+      return false;
+    });
+    front.push_back(labels_.size());
+    queue.push({label.price, label.time, labels_.size()});
+    labels_.push_back(label);
+  }
+
+  // Наименьшее время пути от каждой вершины до finish; граф неориентирован.
+  std::vector<size_t> FastestTimes(Vertex finish) const {
+    std::vector<size_t> res(graph_.size(), kInfinity);
+    using Item = std::pair<size_t, Vertex>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> queue;
+    res[finish] = 0;
+    queue.push({0, finish});
+    while (!queue.empty()) {
+      auto [time, cur] = queue.top();
+      queue.pop();
+      if (time > res[cur]) {
+        continue;
+      }
+      for (Edge edge : graph_[cur]) {
+        if (time + edge.time < res[edge.second]) {
+          res[edge.second] = time + edge.time;
+          queue.push({res[edge.second], edge.second});
+        }
+      }
+    }
+    return res;
   }
-  return opt[finish];
-}
+
+  Path Rebuild(size_t index) const {
+    Path res{labels_[index].price, {}};
+    for (; index != kNoParent; index = labels_[index].parent) {
+      res.vertices.push_back(labels_[index].vertex);
+    }
+    std::reverse(res.vertices.begin(), res.vertices.end());
+    return res;
+  }
+
+  const Graph& graph_;
+  std::vector<Label> labels_;
+  std::vector<std::vector<size_t>> fronts_;
+  std::vector<size_t> min_time_;
+};
 
 int main() {
   size_t num_vertices, num_edges, max_time;
@@ -71,13 +158,13 @@ int main() {
     graph[edge.first].push_back(edge);
     graph[edge.second].push_back(edge.Reverse());
   }
-  auto res = FindPath(graph, 1, num_vertices, max_time);
-  if (res.Empty()) {
+  auto res = ParetoPathSearch(graph)(1, num_vertices, max_time);
+  if (!res.has_value()) {
     std::cout << -1 << std::endl;
   } else {
-    std::cout << res.price << std::endl;
-    std::cout << res.path.size() << std::endl;
-    for (Vertex vertex : res.path) {
+    std::cout << res->price << std::endl;
+    std::cout << res->vertices.size() << std::endl;
+    for (Vertex vertex : res->vertices) {
       std::cout << vertex << " ";
     }
     std::cout << std::endl;
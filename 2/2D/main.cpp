@@ -1,9 +1,20 @@
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
 using Vertex = size_t;
 
+static constexpr int kNoPath = 30000;
+
 struct Edge {
   Vertex first;
   Vertex second;
@@ -16,7 +27,6 @@ struct Graph {
 };
 
 std::vector<int> FindLengths(const Graph& graph, Vertex start) {
-  constexpr int kNoPath = 30000;
   std::vector<int> lengths(graph.vertices.size(), kNoPath);
   lengths[start - 1] = 0;
   bool change = false;
@@ -34,7 +44,220 @@ std::vector<int> FindLengths(const Graph& graph, Vertex start) {
   return lengths;
 }
 
-int main() {
+// Рёбра, сгруппированные по началу; вершины перенумерованы с нуля.
+class CsrGraph {
+ public:
+  struct Arc {
+    Vertex to;
+    int weight;
+  };
+
+  explicit CsrGraph(const Graph& graph)
+      : offsets_(graph.vertices.size() + 1, 0), arcs_(graph.edges.size()) {
+    for (Edge edge : graph.edges) {
+      ++offsets_[edge.first - 1];
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    for (Edge edge : graph.edges) {
+      arcs_[--offsets_[edge.first - 1]] = {edge.second - 1, edge.weight};
+    }
+  }
+
+  size_t VerticesCount() const { return offsets_.size() - 1; }
+
+  std::span<const Arc> GetNeighbours(Vertex vertex) const {
+    return {arcs_.data() + offsets_[vertex],
+            arcs_.data() + offsets_[vertex + 1]};
+  }
+
+ private:
+  std::vector<size_t> offsets_;
+  std::vector<Arc> arcs_;
+};
+
+// Вершинно-ориентированный движок в стиле Pregel. На каждом супершаге
+// Program::Compute вызывается для вершин, которые получили сообщение или не
+// проголосовали за остановку. Сообщения одной вершине сразу сливаются
+// комбинатором в атомарной ячейке следующего буфера, буферы меняются местами
+// между супершагами. Program::kIdentity -- нейтральный элемент комбинатора,
+// он же означает отсутствие сообщения. Вершины -- числа из [0, n).
+template <typename Graph, typename Program>
+class PregelEngine {
+ public:
+  using Value = typename Program::Value;
+  using Message = typename Program::Message;
+
+  class Context {
+   public:
+    const Graph& GetGraph() const { return engine_.graph_; }
+
+    size_t Superstep() const { return engine_.superstep_; }
+
+    void SendMessage(size_t vertex, Message message) {
+      engine_.Send(vertex, message);
+    }
+
+   private:
+    friend class PregelEngine;
+
+    explicit Context(PregelEngine& engine) : engine_(engine) {}
+
+    PregelEngine& engine_;
+  };
+
+  PregelEngine(const Graph& graph, const Program& program,
+               size_t num_threads = 1)
+      : graph_(graph),
+        program_(program),
+        num_threads_(std::max<size_t>(1, num_threads)),
+        values_(graph.VerticesCount()),
+        active_(graph.VerticesCount(), 1),
+        inbox_(graph.VerticesCount()),
+        outbox_(graph.VerticesCount()) {
+    for (size_t vertex = 0; vertex < values_.size(); ++vertex) {
+      values_[vertex] = program_.Initialize(vertex);
+      inbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+      outbox_[vertex].store(Program::kIdentity, std::memory_order_relaxed);
+    }
+  }
+
+  const std::vector<Value>& operator()() {
+    std::barrier sync(num_threads_, [this]() noexcept { FinishSuperstep(); });
+    auto worker = [this, &sync]() {
+      Context context(*this);
+      while (!done_) {
+        for (size_t begin = NextBlock(); begin < values_.size();
+             begin = NextBlock()) {
+          size_t end = std::min(values_.size(), begin + kBlockSize);
+          for (size_t vertex = begin; vertex < end; ++vertex) {
+            ComputeVertex(vertex, context);
+          }
+        }
+        sync.arrive_and_wait();
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_threads_; ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+      thread.join();
+    }
+    return values_;
+  }
+
+  size_t SuperstepsCount() const { return superstep_; }
+
+ private:
+  static constexpr size_t kBlockSize = 1024;
+
+  size_t NextBlock() {
+    return next_block_.fetch_add(kBlockSize, std::memory_order_relaxed);
+  }
+
+  void ComputeVertex(size_t vertex, Context& context) {
+    Message message =
+        inbox_[vertex].exchange(Program::kIdentity, std::memory_order_relaxed);
+    if ((active_[vertex] == 0) && (message == Program::kIdentity)) {
+      return;
+    }
+    active_[vertex] =
+        program_.Compute(vertex, values_[vertex], message, context) ? 1 : 0;
+    if (active_[vertex] != 0) {
+      MarkProgress();
+    }
+  }
+
+  void Send(size_t vertex, Message message) {
+    MarkProgress();
+    std::atomic<Message>& cell = outbox_[vertex];
+    Message current = cell.load(std::memory_order_relaxed);
+    Message combined = Program::Combine(current, message);
+    while ((combined != current) &&
+           !cell.compare_exchange_weak(current, combined,
+                                       std::memory_order_relaxed)) {
+      combined = Program::Combine(current, message);
+    }
+  }
+
+  void MarkProgress() {
+    if (!progress_.load(std::memory_order_relaxed)) {
+      progress_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Выполняется одним потоком, когда все дошли до барьера.
+  void FinishSuperstep() {
+    std::swap(inbox_, outbox_);
+    ++superstep_;
+    next_block_.store(0, std::memory_order_relaxed);
+    done_ = !progress_.exchange(false, std::memory_order_relaxed);
+  }
+
+  const Graph& graph_;
+  Program program_;
+  size_t num_threads_;
+  std::vector<Value> values_;
+  std::vector<uint8_t> active_;
+  std::vector<std::atomic<Message>> inbox_;
+  std::vector<std::atomic<Message>> outbox_;
+  std::atomic<size_t> next_block_ = 0;
+  std::atomic<bool> progress_ = false;
+  size_t superstep_ = 0;
+  bool done_ = false;
+};
+
+// Беллман--Форд: вершина, у которой уменьшилось расстояние, рассылает
+// новые оценки по исходящим рёбрам.
+struct ShortestPathProgram {
+  using Value = int;
+  using Message = int;
+
+  static constexpr Message kIdentity = std::numeric_limits<Message>::max();
+
+  static Message Combine(Message first, Message second) {
+    return std::min(first, second);
+  }
+
+  Value Initialize(size_t /*vertex*/) const { return kNoPath; }
+
+  template <typename Context>
+  bool Compute(size_t vertex, Value& length, Message message,
+               Context& context) const {
+    if ((context.Superstep() == 0) && (vertex == source)) {
+      message = 0;
+    }
+    if (message >= length) {
+      return false;
+    }
+    length = message;
+    for (auto arc : context.GetGraph().GetNeighbours(vertex)) {
+      context.SendMessage(arc.to, length + arc.weight);
+    }
+    return false;
+  }
+
+  Vertex source;
+};
+
+std::vector<int> FindLengths(const Graph& graph, Vertex start,
+                             size_t num_threads) {
+  CsrGraph arcs(graph);
+  PregelEngine<CsrGraph, ShortestPathProgram> engine(
+      arcs, ShortestPathProgram{start - 1}, num_threads);
+  return engine();
+}
+
+void PrintLengths(const std::vector<int>& lengths) {
+  for (auto item : lengths) {
+    std::cout << item << " ";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   size_t num_vertices, num_edges;
   std::cin >> num_vertices >> num_edges;
   std::vector<Vertex> vertices(num_vertices);
@@ -44,9 +267,28 @@ int main() {
     std::cin >> edges[i].first >> edges[i].second >> edges[i].weight;
   }
   Graph graph{vertices, edges};
-  auto res = FindLengths(graph, 1);
-  for (auto item : res) {
-    std::cout << item << " ";
+  size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                  : std::thread::hardware_concurrency();
+  if (mode == "--pregel") {
+    PrintLengths(FindLengths(graph, 1, num_threads));
+    return 0;
   }
-  std::cout << std::endl;
+  if (mode == "--bench") {
+    auto start = std::chrono::steady_clock::now();
+    auto sequential = FindLengths(graph, 1);
+    auto middle = std::chrono::steady_clock::now();
+    auto parallel = FindLengths(graph, 1, num_threads);
+    auto finish = std::chrono::steady_clock::now();
+    std::cerr << "sequential: "
+              << std::chrono::duration<double, std::milli>(middle - start)
+                     .count()
+              << " ms, pregel (" << num_threads << " threads): "
+              << std::chrono::duration<double, std::milli>(finish - middle)
+                     .count()
+              << " ms" << (sequential == parallel ? "" : ", MISMATCH")
+              << std::endl;
+    PrintLengths(parallel);
+    return 0;
+  }
+  PrintLengths(FindLengths(graph, 1));
 }
@@ -1,8 +1,19 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <limits>
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 class Ship {
@@ -67,38 +78,937 @@ class Ship {
   Pricelist pricelist_;
 };
 
+// Четверичная куча над индексами из [0, n) с уменьшением ключа. Позиции
+// индексов хранятся в плоском массиве, так что каждый индекс лежит в куче не
+// больше одного раза.
+template <typename Key>
+class IndexedHeap {
+ public:
+  explicit IndexedHeap(size_t num_indices = 0)
+      : positions_(num_indices, kAbsent) {}
+
+  bool Empty() const { return items_.empty(); }
+
+  size_t Size() const { return items_.size(); }
+
+  const std::pair<Key, size_t>& Top() const { return items_.front(); }
+
+  bool Contains(size_t index) const {
+    return (index < positions_.size()) && (positions_[index] != kAbsent);
+  }
+
+  // Добавляет индекс либо уменьшает его ключ; больший ключ игнорируется.
+  void Push(size_t index, Key key) {
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    size_t pos = positions_[index];
+    if (pos == kAbsent) {
+      pos = items_.size();
+      items_.push_back({key, index});
+    } else if (key < items_[pos].first) {
+      items_[pos].first = key;
+    } else {
+      return;
+    }
+    SiftUp(pos);
+  }
+
+  std::pair<Key, size_t> Pop() {
+    std::pair<Key, size_t> res = items_.front();
+    positions_[res.second] = kAbsent;
+    items_.front() = items_.back();
+    items_.pop_back();
+    if (!items_.empty()) {
+      positions_[items_.front().second] = 0;
+      SiftDown(0);
+    }
+    return res;
+  }
+
+  void Clear() {
+    for (const auto& item : items_) {
+      positions_[item.second] = kAbsent;
+    }
+    items_.clear();
+  }
+
+ private:
+  static constexpr size_t kArity = 4;
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  void SiftUp(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / kArity;
+      if (!(item.first < items_[parent].first)) {
+        break;
+      }
+      Place(pos, items_[parent]);
+      pos = parent;
+    }
+    Place(pos, item);
+  }
+
+  void SiftDown(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (true) {
+      size_t first_child = pos * kArity + 1;
+      if (first_child >= items_.size()) {
+        break;
+      }
+      size_t last_child = std::min(first_child + kArity, items_.size());
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (items_[child].first < items_[best].first) {
+          best = child;
+        }
+      }
+      if (!(items_[best].first < item.first)) {
+        break;
+      }
+      Place(pos, items_[best]);
+      pos = best;
+    }
+    Place(pos, item);
+  }
+
+  void Place(size_t pos, const std::pair<Key, size_t>& item) {
+    items_[pos] = item;
+    positions_[item.second] = pos;
+  }
+
+  std::vector<std::pair<Key, size_t>> items_;
+  std::vector<size_t> positions_;
+};
+
+// Радиксная куча для монотонных целых ключей: запись лежит в корзине по
+// старшему биту, которым её ключ отличается от последнего извлечённого.
+// Интерфейс как у IndexedHeap; при уменьшении ключа добавляется новая
+// запись, а устаревшая пропускается. Ключи в Push не меньше последнего
+// извлечённого.
+template <typename Key>
+class RadixHeap {
+  static_assert(std::is_unsigned_v<Key>, "radix heap keys must be unsigned");
+
+ public:
+  explicit RadixHeap(size_t num_indices = 0)
+      : keys_(num_indices), queued_(num_indices, 0) {}
+
+  bool Empty() const { return size_ == 0; }
+
+  size_t Size() const { return size_; }
+
+  bool Contains(size_t index) const {
+    return (index < queued_.size()) && (queued_[index] != 0);
+  }
+
+  void Push(size_t index, Key key) {
+    if (key < last_) {
+      throw std::logic_error("radix heap keys must be monotone");
+    }
+    if (index >= queued_.size()) {
+      keys_.resize(index + 1);
+      queued_.resize(index + 1, 0);
+    }
+    if (queued_[index] == 0) {
+      queued_[index] = 1;
+      ++size_;
+    } else if (key >= keys_[index]) {
+      return;
+    }
+    keys_[index] = key;
+    buckets_[Bucket(key)].push_back({key, index});
+  }
+
+  std::pair<Key, size_t> Pop() {
+    while (true) {
+      if (buckets_[0].empty()) {
+        Redistribute();
+      }
+      std::pair<Key, size_t> item = buckets_[0].back();
+      buckets_[0].pop_back();
+      if (IsCurrent(item)) {
+        queued_[item.second] = 0;
+        --size_;
+        return item;
+      }
+    }
+  }
+
+  void Clear() {
+    for (auto& bucket : buckets_) {
+      for (const auto& item : bucket) {
+        queued_[item.second] = 0;
+      }
+      bucket.clear();
+    }
+    size_ = 0;
+    last_ = 0;
+  }
+
+ private:
+  static constexpr size_t kBuckets = std::numeric_limits<Key>::digits + 1;
+
+  size_t Bucket(Key key) const { return std::bit_width<Key>(key ^ last_); }
+
+  bool IsCurrent(const std::pair<Key, size_t>& item) const {
+    return (queued_[item.second] != 0) && (keys_[item.second] == item.first);
+  }
+
+  // Минимум первой корзины с актуальными записями становится последним
+  // ключом, а её записи расходятся по корзинам с меньшими номерами.
+  void Redistribute() {
+    for (size_t bucket = 1; bucket < kBuckets; ++bucket) {
+      std::optional<Key> min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item) && (!min.has_value() || (item.first < *min))) {
+          min = item.first;
+        }
+      }
+      if (!min.has_value()) {
+        buckets_[bucket].clear();
+        continue;
+      }
+      last_ = *min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item)) {
+          buckets_[Bucket(item.first)].push_back(item);
+        }
+      }
+      buckets_[bucket].clear();
+      return;
+    }
+  }
+
+  std::array<std::vector<std::pair<Key, size_t>>, kBuckets> buckets_;
+  std::vector<Key> keys_;
+  std::vector<uint8_t> queued_;
+  size_t size_ = 0;
+  Key last_ = 0;
+};
+
+template <typename Queue = IndexedHeap<size_t>>
 size_t FindMinimumPath(const Ship& ship, Ship::Room start, Ship::Room finish) {
   std::vector<size_t> dist(ship.Size() + 1, std::numeric_limits<size_t>::max());
   dist[start] = 0;
-  std::vector<bool> used(ship.Size() + 1);
-  std::priority_queue<std::pair<size_t, Ship::Room>,
-                      std::vector<std::pair<size_t, Ship::Room>>,
-                      std::greater<std::pair<size_t, Ship::Room>>>
-      queue;
-  queue.push({0, start});
-  while (!queue.empty()) {
-    auto cur = queue.top().second;
-    queue.pop();
-    if (used[cur]) {
-      continue;
-    }
-    used[cur] = true;
+  Queue queue(ship.Size() + 1);
+  queue.Push(start, 0);
+  while (!queue.Empty()) {
+    auto cur = queue.Pop().second;
     if (cur == finish) {
       return dist[finish];
     }
     for (auto next : ship.GetNeighbours(cur)) {
       if ((dist[next.first] + next.price < dist[next.second])) {
         dist[next.second] = dist[next.first] + next.price;
-        queue.push({dist[next.second], next.second});
+        queue.Push(next.second, dist[next.second]);
       }
     }
   }
   return dist[finish];
 }
 
-int main() {
+// Параллельный delta-stepping (Meyer--Sanders). Вершины лежат в корзинах
+// ширины delta; лёгкие рёбра (не тяжелее delta) релаксируются фазами, пока
+// текущая корзина не опустеет, тяжёлые -- один раз после этого. Расстояния
+// уменьшаются атомарным минимумом, новые кандидаты копятся в списках потоков.
+// for_each_edge(vertex, relax) вызывает relax(next, weight) для каждого ребра;
+// admissible(vertex, dist) отсекает недопустимые расстояния.
+template <typename Weight>
+class DeltaStepping {
+ public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  DeltaStepping(Weight delta, size_t num_threads)
+      : delta_(std::max<Weight>(1, delta)),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  // Ширина корзины порядка максимального веса, делённого на среднюю степень.
+  static Weight AutoDelta(Weight max_weight, size_t num_vertices,
+                          size_t num_edges) {
+    size_t degree =
+        std::max<size_t>(1, num_edges / std::max<size_t>(1, num_vertices));
+    return std::max<Weight>(1, max_weight / degree);
+  }
+
+  template <typename ForEachEdge>
+  std::vector<Weight> operator()(size_t num_vertices,
+                                 const std::vector<size_t>& starts,
+                                 ForEachEdge for_each_edge) const {
+    return (*this)(num_vertices, starts, for_each_edge,
+                   [](size_t /*unused*/, Weight /*unused*/) { return true; });
+  }
+
+  template <typename ForEachEdge, typename Admissible>
+  std::vector<Weight> operator()(size_t num_vertices,
+                                 const std::vector<size_t>& starts,
+                                 ForEachEdge for_each_edge,
+                                 Admissible admissible) const {
+    std::vector<std::atomic<Weight>> dist(num_vertices);
+    for (auto& value : dist) {
+      value.store(kInfinity, std::memory_order_relaxed);
+    }
+    std::map<Weight, std::vector<size_t>> buckets;
+    for (size_t start : starts) {
+      dist[start].store(0, std::memory_order_relaxed);
+      buckets[0].push_back(start);
+    }
+    std::vector<std::vector<size_t>> requests(num_threads_);
+    while (!buckets.empty()) {
+      auto node = buckets.extract(buckets.begin());
+      Weight index = node.key();
+      std::vector<size_t> frontier = std::move(node.mapped());
+      std::vector<size_t> settled;
+      while (!frontier.empty()) {
+        std::sort(frontier.begin(), frontier.end());
+        frontier.erase(std::unique(frontier.begin(), frontier.end()),
+                       frontier.end());
+        std::erase_if(frontier, [&](size_t vertex) {
+          Weight value = dist[vertex].load(std::memory_order_relaxed);
+          return (value / delta_ != index) || !admissible(vertex, value);
+        });
+        settled.insert(settled.end(), frontier.begin(), frontier.end());
+        Relax(frontier, true, dist, requests, for_each_edge, admissible);
+        frontier.clear();
+        for (auto& list : requests) {
+          for (size_t vertex : list) {
+            Weight bucket =
+                dist[vertex].load(std::memory_order_relaxed) / delta_;
+            (bucket == index ? frontier : buckets[bucket]).push_back(vertex);
+          }
+          list.clear();
+        }
+      }
+      std::sort(settled.begin(), settled.end());
+      settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+      Relax(settled, false, dist, requests, for_each_edge, admissible);
+      for (auto& list : requests) {
+        for (size_t vertex : list) {
+          buckets[dist[vertex].load(std::memory_order_relaxed) / delta_]
+              .push_back(vertex);
+        }
+        list.clear();
+      }
+    }
+    std::vector<Weight> res(num_vertices);
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      res[vertex] = dist[vertex].load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kMinParallelFrontier = 1024;
+
+  template <typename ForEachEdge, typename Admissible>
+  void Relax(const std::vector<size_t>& vertices, bool light,
+             std::vector<std::atomic<Weight>>& dist,
+             std::vector<std::vector<size_t>>& requests,
+             ForEachEdge& for_each_edge, Admissible& admissible) const {
+    auto body = [&](size_t thread, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        Weight base = dist[vertices[i]].load(std::memory_order_relaxed);
+        for_each_edge(vertices[i], [&](size_t next, Weight weight) {
+          if ((weight <= delta_) != light) {
+            return;
+          }
+          Weight candidate = base + weight;
+          if (admissible(next, candidate) && AtomicMin(dist[next], candidate)) {
+            requests[thread].push_back(next);
+          }
+        });
+      }
+    };
+    if ((num_threads_ == 1) || (vertices.size() < kMinParallelFrontier)) {
+      body(0, 0, vertices.size());
+      return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (vertices.size() + num_threads_ - 1) / num_threads_;
+    for (size_t thread = 1; thread < num_threads_; ++thread) {
+      size_t begin = std::min(vertices.size(), thread * chunk);
+      size_t end = std::min(vertices.size(), begin + chunk);
+      workers.emplace_back(body, thread, begin, end);
+    }
+    body(0, 0, std::min(vertices.size(), chunk));
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  static bool AtomicMin(std::atomic<Weight>& value, Weight candidate) {
+    Weight current = value.load(std::memory_order_relaxed);
+    while (candidate < current) {
+      if (value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Weight delta_;
+  size_t num_threads_;
+};
+
+size_t FindMinimumPath(const Ship& ship, Ship::Room start, Ship::Room finish,
+                       const DeltaStepping<size_t>& engine) {
+  return engine(ship.Size() + 1, {start},
+                [&ship](size_t room, auto relax) {
+                  for (auto next : ship.GetNeighbours(room)) {
+                    relax(next.second, next.price);
+                  }
+                })[finish];
+}
+
+// Двунаправленный Дейкстра: прямой поиск от start и обратный от finish по
+// развёрнутому графу чередуются по меньшему ключу. Поиск останавливается,
+// когда сумма минимальных ключей не меньше лучшего пути через вершину,
+// достигнутую обоими поисками; путь собирается по родителям обеих сторон.
+// Графы строятся один раз, расстояния помечаются эпохой запроса.
+template <typename Weight>
+class BidirectionalDijkstra {
+ public:
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+  struct Path {
+    Weight length;
+    std::vector<size_t> vertices;
+  };
+
+  // for_each_edge(vertex, relax) вызывает relax(next, weight) для каждого
+  // ребра, как в DeltaStepping; вызывается дважды на вершину.
+  template <typename ForEachEdge>
+  BidirectionalDijkstra(size_t num_vertices, ForEachEdge for_each_edge) {
+    for (auto& graph : graphs_) {
+      graph.offsets.assign(num_vertices + 1, 0);
+    }
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      for_each_edge(vertex, [&](size_t next, Weight /*unused*/) {
+        ++graphs_[kForward].offsets[vertex + 1];
+        ++graphs_[kBackward].offsets[next + 1];
+      });
+    }
+    for (auto& graph : graphs_) {
+      std::partial_sum(graph.offsets.begin(), graph.offsets.end(),
+                       graph.offsets.begin());
+      graph.targets.resize(graph.offsets.back());
+      graph.weights.resize(graph.offsets.back());
+    }
+    std::array<std::vector<size_t>, 2> filled;
+    for (size_t side : {kForward, kBackward}) {
+      filled[side].assign(graphs_[side].offsets.begin(),
+                          graphs_[side].offsets.end() - 1);
+    }
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      for_each_edge(vertex, [&](size_t next, Weight weight) {
+        Place(kForward, filled[kForward][vertex]++, next, weight);
+        Place(kBackward, filled[kBackward][next]++, vertex, weight);
+      });
+    }
+    for (size_t side : {kForward, kBackward}) {
+      dist_[side].resize(num_vertices);
+      parents_[side].resize(num_vertices);
+      stamps_[side].assign(num_vertices, 0);
+      heaps_[side] = IndexedHeap<Weight>(num_vertices);
+    }
+  }
+
+  std::optional<Path> operator()(size_t start, size_t finish) {
+    if (++epoch_ == 0) {
+      for (auto& stamps : stamps_) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+      }
+      epoch_ = 1;
+    }
+    for (auto& heap : heaps_) {
+      heap.Clear();
+    }
+    Reach(kForward, start, 0, kNoParent);
+    Reach(kBackward, finish, 0, kNoParent);
+    Weight best = (start == finish) ? 0 : kInfinity;
+    size_t meeting = start;
+    while (!heaps_[kForward].Empty() && !heaps_[kBackward].Empty()) {
+      Weight forward_top = heaps_[kForward].Top().first;
+      Weight backward_top = heaps_[kBackward].Top().first;
+      if ((best != kInfinity) && (forward_top + backward_top >= best)) {
+        break;
+      }
+      size_t side = (forward_top <= backward_top) ? kForward : kBackward;
+      auto [dist, cur] = heaps_[side].Pop();
+      ++settled_;
+      const Csr& graph = graphs_[side];
+      for (size_t i = graph.offsets[cur]; i < graph.offsets[cur + 1]; ++i) {
+        size_t next = graph.targets[i];
+        if (dist + graph.weights[i] < GetDistance(side, next)) {
+          Reach(side, next, dist + graph.weights[i], cur);
+        }
+        Weight other = GetDistance(1 - side, next);
+        if ((other != kInfinity) && (GetDistance(side, next) + other < best)) {
+          best = GetDistance(side, next) + other;
+          meeting = next;
+        }
+      }
+    }
+    if (best == kInfinity) {
+      return std::nullopt;
+    }
+    Path res{best, {}};
+    for (size_t vertex = meeting; vertex != kNoParent;
+         vertex = parents_[kForward][vertex]) {
+      res.vertices.push_back(vertex);
+    }
+    std::reverse(res.vertices.begin(), res.vertices.end());
+    for (size_t vertex = parents_[kBackward][meeting]; vertex != kNoParent;
+         vertex = parents_[kBackward][vertex]) {
+      res.vertices.push_back(vertex);
+    }
+    return res;
+  }
+
+  // Число извлечённых из очередей вершин за все запросы.
+  size_t SettledCount() const { return settled_; }
+
+ private:
+  static constexpr size_t kForward = 0;
+  static constexpr size_t kBackward = 1;
+
+  struct Csr {
+    std::vector<size_t> offsets;
+    std::vector<size_t> targets;
+    std::vector<Weight> weights;
+  };
+
+  void Place(size_t side, size_t pos, size_t target, Weight weight) {
+    graphs_[side].targets[pos] = target;
+    graphs_[side].weights[pos] = weight;
+  }
+
+  Weight GetDistance(size_t side, size_t vertex) const {
+    return (stamps_[side][vertex] == epoch_) ? dist_[side][vertex] : kInfinity;
+  }
+
+  void Reach(size_t side, size_t vertex, Weight dist, size_t parent) {
+    dist_[side][vertex] = dist;
+    parents_[side][vertex] = parent;
+    stamps_[side][vertex] = epoch_;
+    heaps_[side].Push(vertex, dist);
+  }
+
+  std::array<Csr, 2> graphs_;
+  std::array<std::vector<Weight>, 2> dist_;
+  std::array<std::vector<size_t>, 2> parents_;
+  std::array<std::vector<uint32_t>, 2> stamps_;
+  std::array<IndexedHeap<Weight>, 2> heaps_;
+  uint32_t epoch_ = 0;
+  size_t settled_ = 0;
+};
+
+size_t FindMinimumPath(Ship::Room start, Ship::Room finish,
+                       BidirectionalDijkstra<size_t>& engine) {
+  auto path = engine(start, finish);
+  return path.has_value() ? path->length : engine.kInfinity;
+}
+
+// Иерархия сжатий (Geisberger--Sanders--Schultes--Delling). Вершины сжимаются
+// по одной; путь u -> v -> w через сжимаемую v заменяется шорткатом u -> w,
+// если ограниченный поиск свидетеля из u в обход v не нашёл пути не длиннее.
+// Порядок -- по разности рёбер (шорткаты минус удаляемые рёбра) с поправкой на
+// число уже сжатых соседей; приоритет пересчитывается лениво при извлечении.
+// Запрос -- двунаправленный Дейкстра, обе стороны которого поднимаются только
+// в вершины, сжатые позже.
+template <typename Weight>
+class ContractionHierarchy {
+ public:
+  using Vertex = uint32_t;
+
+  static constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  // for_each_edge(vertex, relax) вызывает relax(next, weight) для каждого
+  // ребра, как в DeltaStepping.
+  template <typename ForEachEdge>
+  ContractionHierarchy(size_t num_vertices, ForEachEdge for_each_edge) {
+    if (num_vertices > std::numeric_limits<Vertex>::max()) {
+      throw std::overflow_error("too many vertices for the hierarchy");
+    }
+    Contractor contractor(num_vertices);
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      for_each_edge(vertex, [&](size_t next, Weight weight) {
+        contractor.AddArc(vertex, next, weight);
+      });
+    }
+    contractor.Run();
+    graphs_[kForward] = contractor.Flatten(true);
+    graphs_[kBackward] = contractor.Flatten(false);
+    PrepareQueries();
+  }
+
+  static std::optional<ContractionHierarchy> ReadFrom(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+      return std::nullopt;
+    }
+    ContractionHierarchy res;
+    uint64_t header[3];
+    bool ok = (fread(header, sizeof(uint64_t), 3, file) == 3) &&
+              (header[0] == kMagic) && (header[1] == sizeof(Weight)) &&
+              (header[2] <= std::numeric_limits<Vertex>::max());
+    for (auto& graph : res.graphs_) {
+      if (!ok) {
+        break;
+      }
+      graph.offsets.resize(header[2] + 1);
+      ok = Read(file, graph.offsets) && (graph.offsets.front() == 0) &&
+           std::is_sorted(graph.offsets.begin(), graph.offsets.end());
+      if (ok) {
+        graph.targets.resize(graph.offsets.back());
+        graph.weights.resize(graph.offsets.back());
+        ok = Read(file, graph.targets) && Read(file, graph.weights) &&
+             std::all_of(graph.targets.begin(), graph.targets.end(),
+                         [&](Vertex target) { return target < header[2]; });
+      }
+    }
+    fclose(file);
+    if (!ok) {
+      return std::nullopt;
+    }
+    res.PrepareQueries();
+    return res;
+  }
+
+  bool WriteTo(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    uint64_t header[3] = {kMagic, sizeof(Weight), Size()};
+    bool ok = (fwrite(header, sizeof(uint64_t), 3, file) == 3);
+    for (const auto& graph : graphs_) {
+      ok = ok && Write(file, graph.offsets) && Write(file, graph.targets) &&
+           Write(file, graph.weights);
+    }
+    return (fclose(file) == 0) && ok;
+  }
+
+  size_t Size() const { return graphs_[kForward].offsets.size() - 1; }
+
+  size_t CountArcs() const {
+    return graphs_[kForward].targets.size() + graphs_[kBackward].targets.size();
+  }
+
+  // Стороны поиска чередуются по минимальному ключу; поиск останавливается,
+  // когда минимальный ключ не меньше лучшего найденного пути.
+  Weight Query(size_t start, size_t finish) {
+    if ((start >= Size()) || (finish >= Size())) {
+      throw std::out_of_range("vertex out of range");
+    }
+    if (++epoch_ == 0) {
+      for (auto& stamps : stamps_) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+      }
+      epoch_ = 1;
+    }
+    for (auto& heap : heaps_) {
+      heap.Clear();
+    }
+    Reach(kForward, start, 0);
+    Reach(kBackward, finish, 0);
+    Weight best = kInfinity;
+    while (!heaps_[kForward].Empty() || !heaps_[kBackward].Empty()) {
+      size_t side = kForward;
+      if (heaps_[kForward].Empty() ||
+          (!heaps_[kBackward].Empty() &&
+           (heaps_[kBackward].Top().first < heaps_[kForward].Top().first))) {
+        side = kBackward;
+      }
+      auto [dist, cur] = heaps_[side].Pop();
+      if (dist >= best) {
+        break;
+      }
+      Weight other = GetDistance(1 - side, cur);
+      if (other != kInfinity) {
+        best = std::min(best, dist + other);
+      }
+      const UpwardGraph& graph = graphs_[side];
+      for (uint64_t i = graph.offsets[cur]; i < graph.offsets[cur + 1]; ++i) {
+        if (dist + graph.weights[i] < GetDistance(side, graph.targets[i])) {
+          Reach(side, graph.targets[i], dist + graph.weights[i]);
+        }
+      }
+    }
+    return best;
+  }
+
+ private:
+  static constexpr uint64_t kMagic = 0x3130484350494853;  // "SHIPCH01"
+  static constexpr size_t kForward = 0;
+  static constexpr size_t kBackward = 1;
+
+  struct Arc {
+    Vertex target;
+    Weight weight;
+  };
+
+  // Для прямой стороны -- рёбра из вершины в сжатые позже, для обратной --
+  // рёбра в вершину из сжатых позже.
+  struct UpwardGraph {
+    std::vector<uint64_t> offsets;
+    std::vector<Vertex> targets;
+    std::vector<Weight> weights;
+  };
+
+  // Сжимаемый граф: списки входящих и исходящих рёбер, в которых рёбра в
+  // сжатые вершины и кратные рёбра выбрасываются перед сжатием самой вершины.
+  // К этому моменту её соседи не сжаты, так что оставшиеся рёбра ведут вверх.
+  class Contractor {
+   public:
+    explicit Contractor(size_t num_vertices)
+        : out_(num_vertices),
+          in_(num_vertices),
+          out_compacted_(num_vertices, 0),
+          in_compacted_(num_vertices, 0),
+          contracted_(num_vertices, 0),
+          deleted_neighbours_(num_vertices, 0),
+          witness_(num_vertices, kInfinity),
+          heap_(num_vertices) {}
+
+    void AddArc(size_t from, size_t to, Weight weight) {
+      if (from == to) {
+        return;
+      }
+      Append(out_[from], out_compacted_[from],
+             {static_cast<Vertex>(to), weight});
+      Append(in_[to], in_compacted_[to], {static_cast<Vertex>(from), weight});
+    }
+
+    void Run() {
+      IndexedHeap<int64_t> order(out_.size());
+      for (size_t vertex = 0; vertex < out_.size(); ++vertex) {
+        CollectShortcuts(vertex);
+        order.Push(vertex, Priority(vertex));
+      }
+      while (!order.Empty()) {
+        size_t vertex = order.Pop().second;
+        CollectShortcuts(vertex);
+        int64_t priority = Priority(vertex);
+        if (!order.Empty() && (priority > order.Top().first)) {
+          order.Push(vertex, priority);
+          continue;
+        }
+        for (const Shortcut& shortcut : shortcuts_) {
+          AddArc(shortcut.from, shortcut.to, shortcut.weight);
+        }
+        contracted_[vertex] = 1;
+        for (const auto* arcs : {&in_[vertex], &out_[vertex]}) {
+          for (const Arc& arc : *arcs) {
+            ++deleted_neighbours_[arc.target];
+          }
+        }
+      }
+    }
+
+    UpwardGraph Flatten(bool forward) const {
+      const auto& lists = forward ? out_ : in_;
+      UpwardGraph res;
+      res.offsets.reserve(lists.size() + 1);
+      res.offsets.push_back(0);
+      for (const auto& arcs : lists) {
+        for (const Arc& arc : arcs) {
+          res.targets.push_back(arc.target);
+          res.weights.push_back(arc.weight);
+        }
+        res.offsets.push_back(res.targets.size());
+      }
+      return res;
+    }
+
+   private:
+    static constexpr size_t kMaxSettled = 128;
+    static constexpr size_t kMaxExpandedDegree = 64;
+    static constexpr size_t kMinCompacted = 8;
+
+    struct Shortcut {
+      Vertex from;
+      Vertex to;
+      Weight weight;
+    };
+
+    // Список чистится, когда вырастает вдвое с прошлой чистки, иначе рёбра в
+    // сжатые вершины копятся у соседей долго живущих вершин.
+    void Append(std::vector<Arc>& arcs, uint32_t& compacted, Arc arc) {
+      arcs.push_back(arc);
+      if (arcs.size() > 2 * compacted + kMinCompacted) {
+        Compact(arcs);
+        compacted = arcs.size();
+      }
+    }
+
+    void Compact(std::vector<Arc>& arcs) const {
+      std::erase_if(arcs, [&](const Arc& arc) {
+        return contracted_[arc.target] != 0;
+      });
+      std::sort(arcs.begin(), arcs.end(), [](const Arc& lhs, const Arc& rhs) {
+        return std::pair(lhs.target, lhs.weight) <
+               std::pair(rhs.target, rhs.weight);
+      });
+      arcs.erase(std::unique(arcs.begin(), arcs.end(),
+                             [](const Arc& lhs, const Arc& rhs) {
+                               return lhs.target == rhs.target;
+                             }),
+                 arcs.end());
+    }
+
+    // Из вершины с большой исходящей степенью свидетели ищутся обратными
+    // поисками от каждой цели: прямой поиск из неё просматривал бы все её
+    // рёбра при каждой оценке соседа.
+    void CollectShortcuts(size_t vertex) {
+      shortcuts_.clear();
+      Compact(in_[vertex]);
+      Compact(out_[vertex]);
+      in_compacted_[vertex] = in_[vertex].size();
+      out_compacted_[vertex] = out_[vertex].size();
+      for (const Arc& in : in_[vertex]) {
+        std::optional<Weight> limit;
+        for (const Arc& out : out_[vertex]) {
+          if ((out.target != in.target) &&
+              (!limit.has_value() || (*limit < in.weight + out.weight))) {
+            limit = in.weight + out.weight;
+          }
+        }
+        if (!limit.has_value()) {
+          continue;
+        }
+        bool forward = (out_[in.target].size() <= kMaxExpandedDegree);
+        if (forward) {
+          WitnessSearch(out_, in.target, vertex, *limit);
+        }
+        for (const Arc& out : out_[vertex]) {
+          if (out.target == in.target) {
+            continue;
+          }
+          Weight length = in.weight + out.weight;
+          if (!forward) {
+            WitnessSearch(in_, out.target, vertex, length);
+          }
+          if (witness_[forward ? out.target : in.target] > length) {
+            shortcuts_.push_back({in.target, out.target, length});
+          }
+        }
+      }
+    }
+
+    int64_t Priority(size_t vertex) const {
+      return static_cast<int64_t>(shortcuts_.size()) -
+             static_cast<int64_t>(in_[vertex].size() + out_[vertex].size()) +
+             static_cast<int64_t>(deleted_neighbours_[vertex]);
+    }
+
+    // Дейкстра по спискам lists из source в обход avoid не дальше limit и не
+    // больше kMaxSettled извлечений; вершины с большой степенью не
+    // раскрываются. Найденные расстояния -- верхние оценки.
+    void WitnessSearch(const std::vector<std::vector<Arc>>& lists,
+                       Vertex source, size_t avoid, Weight limit) {
+      for (Vertex vertex : touched_) {
+        witness_[vertex] = kInfinity;
+      }
+      touched_.clear();
+      heap_.Clear();
+      witness_[source] = 0;
+      touched_.push_back(source);
+      heap_.Push(source, 0);
+      for (size_t settled = 0; !heap_.Empty() && (settled < kMaxSettled);
+           ++settled) {
+        auto [dist, cur] = heap_.Pop();
+        if (dist > limit) {
+          break;
+        }
+        if (lists[cur].size() > kMaxExpandedDegree) {
+          continue;
+        }
+        for (const Arc& arc : lists[cur]) {
+          if ((contracted_[arc.target] != 0) || (arc.target == avoid) ||
+              (dist + arc.weight >= witness_[arc.target])) {
+            continue;
+          }
+          if (witness_[arc.target] == kInfinity) {
+            touched_.push_back(arc.target);
+          }
+          witness_[arc.target] = dist + arc.weight;
+          heap_.Push(arc.target, dist + arc.weight);
+        }
+      }
+    }
+
+    std::vector<std::vector<Arc>> out_;
+    std::vector<std::vector<Arc>> in_;
+    std::vector<uint32_t> out_compacted_;
+    std::vector<uint32_t> in_compacted_;
+    std::vector<uint8_t> contracted_;
+    std::vector<uint32_t> deleted_neighbours_;
+    std::vector<Weight> witness_;
+    std::vector<Vertex> touched_;
+    IndexedHeap<Weight> heap_;
+    std::vector<Shortcut> shortcuts_;
+  };
+
+  ContractionHierarchy() = default;
+
+  template <typename T>
+  static bool Read(FILE* file, std::vector<T>& values) {
+    return fread(values.data(), sizeof(T), values.size(), file) ==
+           values.size();
+  }
+
+  template <typename T>
+  static bool Write(FILE* file, const std::vector<T>& values) {
+    return fwrite(values.data(), sizeof(T), values.size(), file) ==
+           values.size();
+  }
+
+  void PrepareQueries() {
+    for (size_t side : {kForward, kBackward}) {
+      dist_[side].assign(Size(), kInfinity);
+      stamps_[side].assign(Size(), 0);
+      heaps_[side] = IndexedHeap<Weight>(Size());
+    }
+    epoch_ = 0;
+  }
+
+  Weight GetDistance(size_t side, size_t vertex) const {
+    return (stamps_[side][vertex] == epoch_) ? dist_[side][vertex] : kInfinity;
+  }
+
+  void Reach(size_t side, size_t vertex, Weight dist) {
+    dist_[side][vertex] = dist;
+    stamps_[side][vertex] = epoch_;
+    heaps_[side].Push(vertex, dist);
+  }
+
+  std::array<UpwardGraph, 2> graphs_;
+  std::array<std::vector<Weight>, 2> dist_;
+  std::array<std::vector<uint32_t>, 2> stamps_;
+  std::array<IndexedHeap<Weight>, 2> heaps_;
+  uint32_t epoch_ = 0;
+};
+
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   std::ios_base::sync_with_stdio(false);
   std::cin.tie(0);
+  if ((mode == "--ch") && (argc > 2)) {
+    auto hierarchy = ContractionHierarchy<size_t>::ReadFrom(argv[2]);
+    if (!hierarchy.has_value()) {
+      std::cerr << "cannot read " << argv[2] << std::endl;
+      return 1;
+    }
+    Ship::Room start, finish;
+    while (std::cin >> start >> finish) {
+      std::cout << hierarchy->Query(start, finish) << "\n";
+    }
+    return 0;
+  }
   constexpr Ship::Room kNumRooms = 1000000;
   size_t office, up_price, down_price, num_teleports, enter_price, exit_price;
   std::cin >> office >> up_price >> down_price >> enter_price >> exit_price >>
@@ -114,5 +1024,50 @@ int main() {
   }
   Ship ship(kNumRooms, teleports,
             {up_price, down_price, enter_price, exit_price});
+  if ((mode == "--build-ch") && (argc > 2)) {
+    ContractionHierarchy<size_t> hierarchy(
+        ship.Size() + 1, [&ship](size_t room, auto relax) {
+          for (auto next : ship.GetNeighbours(room)) {
+            relax(next.second, next.price);
+          }
+        });
+    if (!hierarchy.WriteTo(argv[2])) {
+      std::cerr << "cannot write " << argv[2] << std::endl;
+      return 1;
+    }
+    std::cerr << "arcs: " << hierarchy.CountArcs() << std::endl;
+    return 0;
+  }
+  if (mode == "--bidirectional") {
+    BidirectionalDijkstra<size_t> engine(
+        ship.Size() + 1, [&ship](size_t room, auto relax) {
+          for (auto next : ship.GetNeighbours(room)) {
+            relax(next.second, next.price);
+          }
+        });
+    std::cout << FindMinimumPath(1, office, engine) << std::endl;
+    std::cerr << "settled: " << engine.SettledCount() << std::endl;
+    return 0;
+  }
+  if (mode == "--delta-stepping") {
+    size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                    : std::thread::hardware_concurrency();
+    size_t num_paths = 2 * kNumRooms;
+    for (const auto& teleport : teleports) {
+      num_paths += 2 * teleport.size();
+    }
+    size_t max_price =
+        std::max({up_price, down_price, enter_price, exit_price});
+    DeltaStepping<size_t> engine(
+        DeltaStepping<size_t>::AutoDelta(max_price, ship.Size(), num_paths),
+        num_threads);
+    std::cout << FindMinimumPath(ship, 1, office, engine) << std::endl;
+    return 0;
+  }
+  if (mode == "--radix-heap") {
+    std::cout << FindMinimumPath<RadixHeap<size_t>>(ship, 1, office)
+              << std::endl;
+    return 0;
+  }
   std::cout << FindMinimumPath(ship, 1, office) << std::endl;
 }
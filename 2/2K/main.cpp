@@ -1,9 +1,16 @@
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <optional>
-#include <queue>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 template <typename T>
 class DisjointSetUnion {
@@ -70,32 +77,233 @@ struct Tube {
 
 using Station = std::vector<std::vector<Tube>>;
 
-using QueueItem = std::pair<size_t, Room>;
+// Четверичная куча над индексами из [0, n) с уменьшением ключа. Позиции
+// индексов хранятся в плоском массиве, так что каждый индекс лежит в куче не
+// больше одного раза.
+template <typename Key>
+class IndexedHeap {
+ public:
+  explicit IndexedHeap(size_t num_indices = 0)
+      : positions_(num_indices, kAbsent) {}
+
+  bool Empty() const { return items_.empty(); }
+
+  size_t Size() const { return items_.size(); }
+
+  bool Contains(size_t index) const {
+    return (index < positions_.size()) && (positions_[index] != kAbsent);
+  }
+
+  // Добавляет индекс либо уменьшает его ключ; больший ключ игнорируется.
+  void Push(size_t index, Key key) {
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    size_t pos = positions_[index];
+    if (pos == kAbsent) {
+      pos = items_.size();
+      items_.push_back({key, index});
+    } else if (key < items_[pos].first) {
+      items_[pos].first = key;
+    } else {
+      return;
+    }
+    SiftUp(pos);
+  }
+
+  std::pair<Key, size_t> Pop() {
+    std::pair<Key, size_t> res = items_.front();
+    positions_[res.second] = kAbsent;
+    items_.front() = items_.back();
+    items_.pop_back();
+    if (!items_.empty()) {
+      positions_[items_.front().second] = 0;
+      SiftDown(0);
+    }
+    return res;
+  }
+
+  void Clear() {
+    for (const auto& item : items_) {
+      positions_[item.second] = kAbsent;
+    }
+    items_.clear();
+  }
+
+ private:
+  static constexpr size_t kArity = 4;
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  void SiftUp(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / kArity;
+      if (!(item.first < items_[parent].first)) {
+        break;
+      }
+      Place(pos, items_[parent]);
+      pos = parent;
+    }
+    Place(pos, item);
+  }
 
+  void SiftDown(size_t pos) {
+    std::pair<Key, size_t> item = items_[pos];
+    while (true) {
+      size_t first_child = pos * kArity + 1;
+      if (first_child >= items_.size()) {
+        break;
+      }
+      size_t last_child = std::min(first_child + kArity, items_.size());
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (items_[child].first < items_[best].first) {
+          best = child;
+        }
+      }
+      if (!(items_[best].first < item.first)) {
+        break;
+      }
+      Place(pos, items_[best]);
+      pos = best;
+    }
+    Place(pos, item);
+  }
+
+  void Place(size_t pos, const std::pair<Key, size_t>& item) {
+    items_[pos] = item;
+    positions_[item.second] = pos;
+  }
+
+  std::vector<std::pair<Key, size_t>> items_;
+  std::vector<size_t> positions_;
+};
+
+// Радиксная куча для монотонных целых ключей: запись лежит в корзине по
+// старшему биту, которым её ключ отличается от последнего извлечённого.
+// Интерфейс как у IndexedHeap; при уменьшении ключа добавляется новая
+// запись, а устаревшая пропускается. Ключи в Push не меньше последнего
+// извлечённого.
+template <typename Key>
+class RadixHeap {
+  static_assert(std::is_unsigned_v<Key>, "radix heap keys must be unsigned");
+
+ public:
+  explicit RadixHeap(size_t num_indices = 0)
+      : keys_(num_indices), queued_(num_indices, 0) {}
+
+  bool Empty() const { return size_ == 0; }
+
+  size_t Size() const { return size_; }
+
+  bool Contains(size_t index) const {
+    return (index < queued_.size()) && (queued_[index] != 0);
+  }
+
+  void Push(size_t index, Key key) {
+    if (key < last_) {
+      throw std::logic_error("radix heap keys must be monotone");
+    }
+    if (index >= queued_.size()) {
+      keys_.resize(index + 1);
+      queued_.resize(index + 1, 0);
+    }
+    if (queued_[index] == 0) {
+      queued_[index] = 1;
+      ++size_;
+    } else if (key >= keys_[index]) {
+      return;
+    }
+    keys_[index] = key;
+    buckets_[Bucket(key)].push_back({key, index});
+  }
+
+  std::pair<Key, size_t> Pop() {
+    while (true) {
+      if (buckets_[0].empty()) {
+        Redistribute();
+      }
+      std::pair<Key, size_t> item = buckets_[0].back();
+      buckets_[0].pop_back();
+      if (IsCurrent(item)) {
+        queued_[item.second] = 0;
+        --size_;
+        return item;
+      }
+    }
+  }
+
+  void Clear() {
+    for (auto& bucket : buckets_) {
+      for (const auto& item : bucket) {
+        queued_[item.second] = 0;
+      }
+      bucket.clear();
+    }
+    size_ = 0;
+    last_ = 0;
+  }
+
+ private:
+  static constexpr size_t kBuckets = std::numeric_limits<Key>::digits + 1;
+
+  size_t Bucket(Key key) const { return std::bit_width<Key>(key ^ last_); }
+
+  bool IsCurrent(const std::pair<Key, size_t>& item) const {
+    return (queued_[item.second] != 0) && (keys_[item.second] == item.first);
+  }
+
+  // Минимум первой корзины с актуальными записями становится последним
+  // ключом, а её записи расходятся по корзинам с меньшими номерами.
+  void Redistribute() {
+    for (size_t bucket = 1; bucket < kBuckets; ++bucket) {
+      std::optional<Key> min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item) && (!min.has_value() || (item.first < *min))) {
+          min = item.first;
+        }
+      }
+      if (!min.has_value()) {
+        buckets_[bucket].clear();
+        continue;
+      }
+      last_ = *min;
+      for (const auto& item : buckets_[bucket]) {
+        if (IsCurrent(item)) {
+          buckets_[Bucket(item.first)].push_back(item);
+        }
+      }
+      buckets_[bucket].clear();
+      return;
+    }
+  }
+
+  std::array<std::vector<std::pair<Key, size_t>>, kBuckets> buckets_;
+  std::vector<Key> keys_;
+  std::vector<uint8_t> queued_;
+  size_t size_ = 0;
+  Key last_ = 0;
+};
+
+template <typename Queue = IndexedHeap<size_t>>
 std::vector<std::pair<size_t, Tube>> FindLengths(
     const Station& station, const std::vector<Room>& starts) {
   constexpr size_t kInfinity = std::numeric_limits<size_t>::max();
   std::vector<size_t> dist(station.size(), kInfinity);
-  std::priority_queue<QueueItem, std::vector<QueueItem>,
-                      std::greater<QueueItem>>
-      queue;
+  Queue queue(station.size());
   for (Room start : starts) {
     dist[start] = 0;
-    queue.push({0, start});
+    queue.Push(start, 0);
   }
-  std::vector<bool> used(station.size(), false);
   std::vector<std::pair<size_t, Tube>> tubes;
-  while (!queue.empty()) {
-    Room cur = queue.top().second;
-    queue.pop();
-    if (used[cur]) {
-      continue;
-    }
-    used[cur] = true;
+  while (!queue.Empty()) {
+    Room cur = queue.Pop().second;
     for (Tube edge : station[cur]) {
       tubes.push_back({0, edge});
-      dist[edge.second] = std::min(dist[edge.second], dist[cur] + edge.length);
-      queue.push({dist[edge.second], edge.second});
+      if (dist[cur] + edge.length < dist[edge.second]) {
+        dist[edge.second] = dist[cur] + edge.length;
+        queue.Push(edge.second, dist[edge.second]);
+      }
     }
   }
   for (size_t i = 0; i < tubes.size(); ++i) {
@@ -134,7 +342,8 @@ struct Query {
   size_t limit;
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+  std::string mode = (argc > 1) ? argv[1] : "";
   size_t num_rooms, num_tubes, num_rechargers;
   std::cin >> num_rooms >> num_rechargers >> num_tubes;
   std::vector<Room> rechargers(num_rechargers);
@@ -148,7 +357,9 @@ int main() {
     station[tube.first].push_back(tube);
     station[tube.second].push_back(tube.Inverse());
   }
-  auto tubes = FindLengths(station, rechargers);
+  auto tubes = (mode == "--radix-heap")
+                   ? FindLengths<RadixHeap<size_t>>(station, rechargers)
+                   : FindLengths(station, rechargers);
   DisjointSetUnion<Room> connect;
   for (size_t v = 1; v <= station.size(); ++v) {
     connect.MakeSet(v);
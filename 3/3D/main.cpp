@@ -1,7 +1,11 @@
 #include <algorithm>
+#include <cstdint>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -60,12 +64,21 @@ class DisjointSetUnion {
   std::unordered_map<T, size_t> rank_;
 };
 
-using Vertex = size_t;
 using Graph = std::vector<std::vector<size_t>>;
 
+template <typename Index>
+Index CheckedIndex(size_t value) {
+  static_assert(std::is_unsigned_v<Index>, "index type must be unsigned");
+  if (value > std::numeric_limits<Index>::max()) {
+    throw std::overflow_error("index does not fit into the index type");
+  }
+  return static_cast<Index>(value);
+}
+
+template <typename Index = uint32_t>
 struct Edge {
-  Vertex first;
-  Vertex second;
+  Index first;
+  Index second;
   size_t weight;
 };
 
@@ -76,20 +89,22 @@ std::vector<Integer> GenerateSequence(Integer start, Integer end) {
   return res;
 }
 
+template <typename Index = uint32_t>
 size_t GetMinimumCost(const Graph& graph) {
+  const Index num_vertices = CheckedIndex<Index>(graph.size());
   size_t cost = 0;
-  std::vector<Edge> edges;
-  for (Vertex u = 0; u < graph.size(); ++u) {
-    for (Vertex v = 0; v < graph.size(); ++v) {
+  std::vector<Edge<Index>> edges;
+  for (Index u = 0; u < num_vertices; ++u) {
+    for (Index v = 0; v < num_vertices; ++v) {
       if (u == v) {
         continue;
       }
-      edges.push_back(Edge{u, v, graph[u][v]});
+      edges.push_back(Edge<Index>{u, v, graph[u][v]});
     }
   }
-  DisjointSetUnion<Vertex> connect(GenerateSequence<Vertex>(0, graph.size()));
-  std::sort(edges.begin(), edges.end(), [](Edge first, Edge second) { return first.weight < second.weight; });
-  for (Edge edge : edges) {
+  DisjointSetUnion<Index> connect(GenerateSequence<Index>(0, num_vertices));
+  std::sort(edges.begin(), edges.end(), [](Edge<Index> first, Edge<Index> second) { return first.weight < second.weight; });
+  for (Edge<Index> edge : edges) {
     if (!connect.IsSameSet(edge.first, edge.second)) {
       cost += edge.weight;
       connect.Unite(edge.first, edge.second);
@@ -102,12 +117,12 @@ int main() {
   size_t num_candidates;
   std::cin >> num_candidates;
   Graph costs(num_candidates + 1, std::vector<size_t>(num_candidates + 1, 0));
-  for (Vertex u = 1; u <= num_candidates; ++u) {
-    for (Vertex v = 1; v <= num_candidates; ++v) {
+  for (size_t u = 1; u <= num_candidates; ++u) {
+    for (size_t v = 1; v <= num_candidates; ++v) {
       std::cin >> costs[u][v];
     }
   }
-  for (Vertex c = 1; c <= num_candidates; ++c) {
+  for (size_t c = 1; c <= num_candidates; ++c) {
     size_t cost;
     std::cin >> cost;
     costs[0][c] = costs[c][0] = cost;
@@ -1,7 +1,14 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <queue>
+#include <stdexcept>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace Visitor {
@@ -63,18 +70,21 @@ struct Edge {
   int64_t CurrentCapacity() { return capacity - flow; }
 };
 
+// Дуги хранятся массивом, отсортированным по (from, to), и нарезаются на
+// списки смежности смещениями; для каждой дуги запоминается номер обратной.
 template <class Vertex, class Edge>
 class EdgeGraph {
  private:
-  std::unordered_map<uint64_t, Edge> edge_from_id_;
-  std::vector<std::vector<Vertex>> incident_vertices_;
+  std::vector<Edge> edges_;
+  std::vector<size_t> offsets_;
+  std::vector<size_t> reverse_;
   std::vector<Vertex> vertices_;
 
  public:
   using VertexType = Vertex;
   using EdgeType = Edge;
 
-  EdgeGraph(int num_vertices) : incident_vertices_(num_vertices + 1, std::vector<Vertex>()) {
+  EdgeGraph(int num_vertices) : offsets_(num_vertices + 2, 0) {
     vertices_.push_back(-1);
     for (int i = 1; i <= num_vertices; ++i) {
       vertices_.push_back(i);
@@ -83,36 +93,173 @@ class EdgeGraph {
 
   size_t GetVertecesCount() { return vertices_.size() - 1; }
 
-  std::vector<Vertex>& GetIncidents(Vertex v) { return incident_vertices_[v]; }
-  Edge& GetEdge(uint64_t edge_id) { return edge_from_id_[edge_id]; }
+  size_t ArcsBegin(Vertex v) const { return offsets_[v]; }
+  size_t ArcsEnd(Vertex v) const { return offsets_[v + 1]; }
+  Edge& GetEdge(size_t edge_id) { return edges_[edge_id]; }
+  size_t GetReverse(size_t edge_id) const { return reverse_[edge_id]; }
 
-  Edge& GetEdge(Vertex from, Vertex to) {
-    return edge_from_id_[from * kShift + to];
+  // Номер дуги from -> to двоичным поиском по списку from.
+  size_t FindEdge(Vertex from, Vertex to) const {
+    auto begin = edges_.begin() + offsets_[from];
+    auto end = edges_.begin() + offsets_[from + 1];
+    return std::lower_bound(begin, end, to,
+                            [](const Edge& edge, Vertex target) {
+                              return edge.to < target;
+                            }) -
+           edges_.begin();
   }
 
-  void AddEdge(Vertex from, Vertex to, int64_t capacity,
-               int64_t flow) {  // {from, to} -> edge[from « 32 | to]
-    if (edge_from_id_.find(from * kShift + to) == edge_from_id_.end()) {
-      edge_from_id_[from * kShift + to] = Edge(from, to, capacity, flow);
-      incident_vertices_[from].push_back(to);
-    } else {
-      edge_from_id_[from * kShift + to].capacity += capacity;
+  // arcs -- канонический массив: отсортирован по (from, to), без повторов
+  // и вместе с каждой дугой содержит обратную.
+  void SetArcs(std::vector<Edge> arcs) {
+    edges_ = std::move(arcs);
+    std::fill(offsets_.begin(), offsets_.end(), 0);
+    for (const auto& edge : edges_) {
+      ++offsets_[edge.from + 1];
+    }
+    for (size_t v = 1; v < offsets_.size(); ++v) {
+      offsets_[v] += offsets_[v - 1];
+    }
+    reverse_.resize(edges_.size());
+    for (size_t id = 0; id < edges_.size(); ++id) {
+      reverse_[id] = FindEdge(edges_[id].to, edges_[id].from);
+    }
+  }
+};
+
+// Канонизация рёбер при загрузке: рёбра поразрядно сортируются по
+// упакованному ключу (u, v) в несколько потоков, рёбра с одинаковым ключом
+// сливаются функцией merge, петли по желанию отбрасываются.
+template <typename Key, typename Merge>
+class EdgeCanonicalizer {
+ public:
+  EdgeCanonicalizer(Key key, Merge merge, bool drop_loops = true,
+                    size_t num_threads = std::thread::hardware_concurrency())
+      : key_(key),
+        merge_(merge),
+        drop_loops_(drop_loops),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  template <typename Edge>
+  std::vector<Edge> operator()(std::vector<Edge> edges) const {
+    std::vector<uint64_t> keys(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      keys[i] = Pack(key_(edges[i]));
+    }
+    Sort(edges, keys);
+    std::vector<Edge> res;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (drop_loops_ && ((keys[i] >> kHalfBits) == (keys[i] & kHalfMask))) {
+        continue;
+      }
+      if (!res.empty() && (keys[i] == keys[i - 1])) {
+        merge_(res.back(), edges[i]);
+      } else {
+        res.push_back(edges[i]);
+      }
+    }
+    return res;
+  }
+
+ private:
+  static constexpr size_t kHalfBits = 32;
+  static constexpr uint64_t kHalfMask = (uint64_t{1} << kHalfBits) - 1;
+  static constexpr size_t kDigitBits = 8;
+  static constexpr size_t kBuckets = size_t{1} << kDigitBits;
+  static constexpr size_t kMinChunk = size_t{1} << 16;
+
+  template <typename Pair>
+  static uint64_t Pack(const Pair& pair) {
+    auto first = static_cast<uint64_t>(pair.first);
+    auto second = static_cast<uint64_t>(pair.second);
+    if ((first > kHalfMask) || (second > kHalfMask)) {
+      throw std::overflow_error("vertex does not fit into the edge key");
+    }
+    return (first << kHalfBits) | second;
+  }
+
+  // Устойчивая LSD-сортировка по байтам ключа: каждый поток считает
+  // гистограмму своего куска, а затем раскладывает его по своим смещениям.
+  template <typename Edge>
+  void Sort(std::vector<Edge>& edges, std::vector<uint64_t>& keys) const {
+    size_t num_threads =
+        std::min(num_threads_, std::max<size_t>(1, edges.size() / kMinChunk));
+    size_t chunk = (edges.size() + num_threads - 1) / num_threads;
+    uint64_t max_key = 0;
+    for (uint64_t key : keys) {
+      max_key = std::max(max_key, key);
+    }
+    std::vector<Edge> edges_buffer(edges.size());
+    std::vector<uint64_t> keys_buffer(keys.size());
+    std::vector<std::array<size_t, kBuckets>> offsets(num_threads);
+    for (size_t shift = 0; (shift < 64) && ((max_key >> shift) != 0);
+         shift += kDigitBits) {
+      ForEachChunk(num_threads, [&](size_t thread) {
+        offsets[thread].fill(0);
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          ++offsets[thread][(keys[i] >> shift) & (kBuckets - 1)];
+        }
+      });
+      size_t total = 0;
+      for (size_t digit = 0; digit < kBuckets; ++digit) {
+        for (auto& counts : offsets) {
+          std::swap(counts[digit], total);
+          total += counts[digit];
+        }
+      }
+      ForEachChunk(num_threads, [&](size_t thread) {
+        size_t end = std::min(keys.size(), (thread + 1) * chunk);
+        for (size_t i = thread * chunk; i < end; ++i) {
+          size_t pos = offsets[thread][(keys[i] >> shift) & (kBuckets - 1)]++;
+          edges_buffer[pos] = edges[i];
+          keys_buffer[pos] = keys[i];
+        }
+      });
+      std::swap(edges, edges_buffer);
+      std::swap(keys, keys_buffer);
+    }
+  }
+
+  template <typename Body>
+  static void ForEachChunk(size_t num_threads, Body body) {
+    std::vector<std::thread> workers;
+    for (size_t thread = 1; thread < num_threads; ++thread) {
+      workers.emplace_back(body, thread);
+    }
+    body(0);
+    for (auto& worker : workers) {
+      worker.join();
     }
   }
 
-  static constexpr Vertex kShift = 1337;
+  Key key_;
+  Merge merge_;
+  bool drop_loops_;
+  size_t num_threads_;
 };
 
 template <typename Graph>
 void ReadEdges(Graph& graph, size_t num_edges) {
+  std::vector<typename Graph::EdgeType> arcs;
+  arcs.reserve(2 * num_edges);
   for (size_t i = 0; i < num_edges; ++i) {
     typename Graph::VertexType from;
     typename Graph::VertexType to;
     int64_t capacity;
     std::cin >> from >> to >> capacity;
-    graph.AddEdge(from, to, capacity, 0);
-    graph.AddEdge(to, from, 0, 0);
+    arcs.emplace_back(from, to, capacity, 0);
+    arcs.emplace_back(to, from, 0, 0);
   }
+  EdgeCanonicalizer canonicalize(
+      [](const typename Graph::EdgeType& edge) {
+        return std::make_pair(edge.from, edge.to);
+      },
+      [](typename Graph::EdgeType& edge,
+         const typename Graph::EdgeType& parallel) {
+        edge.capacity += parallel.capacity;
+      });
+  graph.SetArcs(canonicalize(std::move(arcs)));
 }
 
 template <class Vertex, class Edge, class Visitor>
@@ -127,15 +274,16 @@ int64_t FindIncreasingPath(EdgeGraph<Vertex, Edge>& graph, Vertex start,
   while (!bfs_queue.empty()) {
     Vertex vertex = bfs_queue.front();
     bfs_queue.pop();
-    for (auto next : graph.GetIncidents(vertex)) {
-      auto edge = graph.GetEdge(vertex, next);
+    for (size_t id = graph.ArcsBegin(vertex); id < graph.ArcsEnd(vertex);
+         ++id) {
+      auto edge = graph.GetEdge(id);
       if (edge.CurrentCapacity() > 0 and
           dist[edge.to] == std::numeric_limits<int64_t>::max()) {
         bfs_queue.push(edge.to);
         dist[edge.to] = dist[edge.from] + 1;
         visitor.Visit(edge);
       }
-      if (next == end) {
+      if (edge.to == end) {
         break;
       }
     }
@@ -147,8 +295,9 @@ int64_t FindIncreasingPath(EdgeGraph<Vertex, Edge>& graph, Vertex start,
     while (next != start) {
       auto pair = visitor.Path()[next];
       auto vertex = pair.first;
-      graph.GetEdge(vertex, next).flow += delta;
-      graph.GetEdge(next, vertex).flow -= delta;
+      size_t id = graph.FindEdge(vertex, next);
+      graph.GetEdge(id).flow += delta;
+      graph.GetEdge(graph.GetReverse(id)).flow -= delta;
       next = vertex;
     }
   }
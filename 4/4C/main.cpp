@@ -1,27 +1,44 @@
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 static constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max();
 
+template <typename Index>
+Index CheckedIndex(size_t value) {
+  static_assert(std::is_unsigned_v<Index>, "index type must be unsigned");
+  if (value > std::numeric_limits<Index>::max()) {
+    throw std::overflow_error("index does not fit into the index type");
+  }
+  return static_cast<Index>(value);
+}
+
+template <typename Index = uint32_t>
 struct Edge {
-  size_t to_vertex;
+  Index to_vertex;
   int64_t flow;
   int64_t capacity;
 
   int64_t CurrentCapacity() const { return capacity - flow; }
 
-  Edge(size_t to_vertex, int64_t capacity)
+  Edge(Index to_vertex, int64_t capacity)
       : to_vertex(to_vertex), flow(0), capacity(capacity) {}
 };
 
+template <typename Index = uint32_t>
 class Graph {
  public:
   Graph(size_t num_vertices, size_t num_edges,
         std::unordered_map<size_t, size_t>& map)
-      : graph_(2 * num_vertices + 1, std::vector<int64_t>()) {
+      : graph_(CheckedIndex<Index>(2 * num_vertices + 1)) {
+    // На каждое входное ребро три вызова AddEdge, по две дуги в каждом.
+    const size_t kArcsPerEdge = 6;
+    CheckedIndex<Index>(kArcsPerEdge * num_edges);
     const size_t kMagicConst = 1500;
     for (size_t i = 1; i <= num_edges; ++i) {
       size_t from;
@@ -37,10 +54,10 @@ class Graph {
   }
 
   void AddEdge(size_t from, size_t to, int64_t capacity) {
-    edges_.emplace_back(to, capacity);
-    graph_[from].emplace_back(edges_.size() - 1);
-    edges_.emplace_back(from, 0);
-    graph_[to].emplace_back(edges_.size() - 1);
+    edges_.emplace_back(static_cast<Index>(to), capacity);
+    graph_[from].emplace_back(CheckedIndex<Index>(edges_.size() - 1));
+    edges_.emplace_back(static_cast<Index>(from), 0);
+    graph_[to].emplace_back(CheckedIndex<Index>(edges_.size() - 1));
   }
 
   std::vector<std::pair<size_t, size_t>> MaxFlow(size_t s_in, size_t t_in,
@@ -81,7 +98,7 @@ class Graph {
       return min;
     }
     used[v_in] = phase;
-    for (int64_t edge_id : graph_[v_in]) {
+    for (Index edge_id : graph_[v_in]) {
       if (edges_[edge_id].CurrentCapacity() == 0) {
         continue;
       }
@@ -109,11 +126,11 @@ class Graph {
     }
   }
 
-  std::vector<std::vector<int64_t>> graph_;
-  std::vector<Edge> edges_;
+  std::vector<std::vector<Index>> graph_;
+  std::vector<Edge<Index>> edges_;
 };
 
-void PrintAnswer(Graph& graph, size_t num_vertices,
+void PrintAnswer(Graph<>& graph, size_t num_vertices,
                  std::unordered_map<size_t, size_t>& map) {
   std::vector<size_t> answer;
   const size_t kMagicConst = 1500;
@@ -132,6 +149,6 @@ int main() {
   size_t num_edges;
   std::cin >> num_vertices >> num_edges;
   std::unordered_map<size_t, size_t> map;
-  Graph graph(num_vertices, num_edges, map);
+  Graph<> graph(num_vertices, num_edges, map);
   PrintAnswer(graph, num_vertices, map);
 }
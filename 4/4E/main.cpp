@@ -1,30 +1,45 @@
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 static constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max();
 
-using Graph = std::vector<std::vector<int64_t>>;
+template <typename Index>
+Index CheckedIndex(size_t value) {
+  static_assert(std::is_unsigned_v<Index>, "index type must be unsigned");
+  if (value > std::numeric_limits<Index>::max()) {
+    throw std::overflow_error("index does not fit into the index type");
+  }
+  return static_cast<Index>(value);
+}
+
+template <typename Index = uint32_t>
+using Graph = std::vector<std::vector<Index>>;
 
+template <typename Index = uint32_t>
 struct Edge {
-  size_t to_vertex;
+  Index to_vertex;
   int64_t capacity;
   int64_t flow;
 
   int64_t CurrentCapacity() const { return capacity - flow; }
 
-  Edge(int64_t to_vertex, int64_t capacity)
+  Edge(Index to_vertex, int64_t capacity)
       : to_vertex(to_vertex), capacity(capacity), flow(0) {}
 };
 
-void AddEdge(Graph& graph, std::vector<Edge>& edges, int64_t from, int64_t to,
-             int64_t capacity) {
-  edges.emplace_back(to, capacity);
-  graph[from].emplace_back(edges.size() - 1);
-  edges.emplace_back(from, 0);
-  graph[to].emplace_back(edges.size() - 1);
+template <typename Index>
+void AddEdge(Graph<Index>& graph, std::vector<Edge<Index>>& edges, size_t from,
+             size_t to, int64_t capacity) {
+  edges.emplace_back(static_cast<Index>(to), capacity);
+  graph[from].emplace_back(CheckedIndex<Index>(edges.size() - 1));
+  edges.emplace_back(static_cast<Index>(from), 0);
+  graph[to].emplace_back(CheckedIndex<Index>(edges.size() - 1));
 }
 
 struct State {
@@ -34,13 +49,15 @@ struct State {
   int64_t min;
 };
 
-int64_t FindIncreasingPath(Graph& graph, std::vector<Edge>& edges,
+template <typename Index>
+int64_t FindIncreasingPath(Graph<Index>& graph,
+                           std::vector<Edge<Index>>& edges,
                            std::vector<size_t>& used, State state) {
   if (state.end == state.current) {
     return state.min;
   }
   used[state.current] = state.phase;
-  for (int64_t edge_id : graph[state.current]) {
+  for (Index edge_id : graph[state.current]) {
     if (edges[edge_id].CurrentCapacity() > 0 &&
         used[edges[edge_id].to_vertex] != state.phase) {
       int64_t delta = FindIncreasingPath(
@@ -57,8 +74,9 @@ int64_t FindIncreasingPath(Graph& graph, std::vector<Edge>& edges,
   return 0;
 }
 
-int64_t MaxFlow(Graph& graph, std::vector<Edge>& edges, size_t start,
-                size_t end) {
+template <typename Index>
+int64_t MaxFlow(Graph<Index>& graph, std::vector<Edge<Index>>& edges,
+                size_t start, size_t end) {
   std::vector<size_t> used(graph.size(), 0);
   size_t phase = 1;
   while (FindIncreasingPath(graph, edges, used,
@@ -67,7 +85,7 @@ int64_t MaxFlow(Graph& graph, std::vector<Edge>& edges, size_t start,
   }
 
   int64_t result = 0;
-  for (int64_t edge_id : graph[start]) {
+  for (Index edge_id : graph[start]) {
     result += edges[edge_id].flow;
   }
   return result;
@@ -102,8 +120,9 @@ struct Params {
   size_t y_coord;
 };
 
-void AddVertexToGraph(std::vector<Edge>& edges, Graph& graph, Field& field,
-                      Params params) {
+template <typename Index>
+void AddVertexToGraph(std::vector<Edge<Index>>& edges, Graph<Index>& graph,
+                      Field& field, Params params) {
   size_t x_coord = params.x_coord;
   size_t y_coord = params.y_coord;
   size_t height = params.height;
@@ -135,9 +154,10 @@ void AddVertexToGraph(std::vector<Edge>& edges, Graph& graph, Field& field,
   }
 }
 
-std::pair<Graph, std::vector<Edge>> ReadGraph(size_t height, size_t width, Field& field) {
-  std::vector<Edge> edges;
-  Graph graph(height * width + 2, std::vector<int64_t>());
+template <typename Index = uint32_t>
+std::pair<Graph<Index>, std::vector<Edge<Index>>> ReadGraph(size_t height, size_t width, Field& field) {
+  std::vector<Edge<Index>> edges;
+  Graph<Index> graph(CheckedIndex<Index>(height * width + 2));
   for (size_t i = 0; i < height; i++) {
     for (size_t j = 0; j < width; j++) {
       AddVertexToGraph(edges, graph, field, {height, width, i, j});